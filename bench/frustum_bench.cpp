@@ -0,0 +1,51 @@
+// Headless benchmark for ChunkCuller: reports the cost of culling 10k
+// chunks against a camera frustum that sweeps a full turn.
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Frustum/Frustum.h"
+
+int main(int argc, char** argv) {
+    constexpr float chunkSize = 16.0f;
+    int radius = 15;
+    int iterations = 2000;
+    if (argc > 1) radius = std::atoi(argv[1]);
+    if (argc > 2) iterations = std::atoi(argv[2]);
+
+    std::vector<glm::ivec3> coords;
+    for (int x = -radius; x <= radius; ++x)
+        for (int y = -radius; y <= radius; ++y)
+            for (int z = -radius; z <= radius; ++z)
+                coords.push_back({x, y, z});
+
+    ChunkCuller culler;
+    culler.SetChunks(coords, chunkSize);
+    glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    std::vector<uint32_t> visible;
+    visible.reserve(coords.size());
+
+    size_t totalVisible = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        float yaw = glm::radians(360.0f * static_cast<float>(it) / static_cast<float>(iterations));
+        glm::vec3 front(std::cos(yaw), 0.0f, std::sin(yaw));
+        glm::mat4 view = glm::lookAt(glm::vec3(8.0f), glm::vec3(8.0f) + front, glm::vec3(0, 1, 0));
+        Frustum frustum = Frustum::FromMatrix(projection * view);
+        visible.clear();
+        culler.Cull(frustum, visible);
+        totalVisible += visible.size();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    double nsPerChunk = ns / (static_cast<double>(iterations) * static_cast<double>(coords.size()));
+    std::cout << "chunks: " << coords.size() << "\n";
+    std::cout << "iterations: " << iterations << "\n";
+    std::cout << "visible: " << (100.0 * totalVisible) / (static_cast<double>(iterations) * coords.size()) << "%\n";
+    std::cout << "cull cost: " << nsPerChunk * 10000.0 / 1000.0 << " us per 10k chunks\n";
+    return 0;
+}
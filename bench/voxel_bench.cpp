@@ -0,0 +1,1135 @@
+// Headless chunk pipeline benchmark. Links only the World code and never
+// opens a window, so it can run on CI machines and track regressions.
+//
+//   voxel_bench [--json] [--verify] [--scaling] [--iterations N] [--format pulled|indexed]
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "World/World.h"
+#include "BufferArena/BufferArena.h"
+#include "StagingUploader/StagingUploader.h"
+#include "FrameBudget/FrameBudget.h"
+#include "Clipmap/Clipmap.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchResult {
+    std::string name;
+    double nsPerChunk = 0.0;
+    double quadsPerChunk = 0.0;
+    double bytesPerChunk = 0.0;
+};
+
+enum class Terrain {
+    Flat,
+    Noisy,
+    Checkerboard,
+    Empty,
+    Full
+};
+
+static const char* TerrainName(Terrain t) {
+    switch (t) {
+        case Terrain::Flat: return "flat";
+        case Terrain::Noisy: return "noisy";
+        case Terrain::Checkerboard: return "checkerboard";
+        case Terrain::Empty: return "empty";
+        case Terrain::Full: return "full";
+    }
+    return "";
+}
+
+static uint32_t Hash2(int x, int z) {
+    uint32_t h = static_cast<uint32_t>(x) * 0x8da6b343u ^ static_cast<uint32_t>(z) * 0xd8163841u;
+    h ^= h >> 13;
+    h *= 0x85ebca6bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// Patterns are functions of global block coordinates so neighbouring chunks
+// line up with the chunk under test.
+static bool IsSolid(Terrain t, int x, int y, int z) {
+    switch (t) {
+        case Terrain::Flat: return y < CHUNK_SIZE / 2;
+        case Terrain::Noisy: return y < static_cast<int>(Hash2(x, z) % CHUNK_SIZE);
+        case Terrain::Checkerboard: return ((x + y + z) & 1) == 0;
+        case Terrain::Empty: return false;
+        case Terrain::Full: return true;
+    }
+    return false;
+}
+
+static Chunk MakeChunk(Terrain t, glm::ivec3 coord) {
+    std::array<BlockType, Chunk::VOLUME> dense;
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                dense[x + y * Chunk::CS + z * Chunk::CS_SQR] =
+                    IsSolid(t, coord.x * CHUNK_SIZE + x, coord.y * CHUNK_SIZE + y, coord.z * CHUNK_SIZE + z) ? BlockType::SOLID : BlockType::AIR;
+    Chunk chunk;
+    chunk.assign(dense);
+    return chunk;
+}
+
+static void StoreNeighbourhood(World& world, Terrain t) {
+    world.setChunkWindow({0, 0, 0}, 1);
+    world.storeChunk({0, 0, 0}, MakeChunk(t, {0, 0, 0}));
+    for (int d = 0; d < 6; ++d) {
+        glm::ivec3 c(0);
+        c[d / 2] = (d % 2 == 0) ? 1 : -1;
+        world.storeChunk(c, MakeChunk(t, c));
+    }
+}
+
+static size_t QuadCount(const WorkResult& mesh) {
+    return mesh.quads.size() + mesh.vertices.size() / 4;
+}
+
+static size_t MeshBytes(const WorkResult& mesh) {
+    return mesh.quads.size() * sizeof(PackedQuad)
+         + mesh.vertices.size() * sizeof(PackedVertex)
+         + mesh.indices.size() * sizeof(GLuint);
+}
+
+// Every unit face a mesh covers, as (face, x, y, z). Works for both mesh
+// formats since the first vertex of each indexed quad carries the quad's
+// origin and size.
+static std::set<std::tuple<int, int, int, int>> Coverage(const WorkResult& mesh) {
+    std::vector<PackedVertex> records = mesh.quads;
+    for (size_t i = 0; i < mesh.vertices.size(); i += 4) records.push_back(mesh.vertices[i]);
+    std::set<std::tuple<int, int, int, int>> cells;
+    for (const auto& r : records) {
+        int p[3] = {static_cast<int>(r.Data0 & 63u), static_cast<int>((r.Data0 >> 6) & 63u), static_cast<int>((r.Data0 >> 12) & 63u)};
+        int face = static_cast<int>((r.Data0 >> 18) & 7u);
+        int width = static_cast<int>(r.Data1 & 63u);
+        int height = static_cast<int>((r.Data1 >> 6) & 63u);
+        int axis = face / 2;
+        int heightAxis = (axis == 0) ? 1 : 0;
+        int widthAxis = (axis == 2) ? 1 : 2;
+        for (int h = 0; h < height; ++h) {
+            for (int w = 0; w < width; ++w) {
+                int q[3] = {p[0], p[1], p[2]};
+                q[heightAxis] += h;
+                q[widthAxis] += w;
+                cells.insert({face, q[0], q[1], q[2]});
+            }
+        }
+    }
+    return cells;
+}
+
+static BenchResult BenchMesh(World& world, Terrain t, MesherKind kind, int iterations) {
+    StoreNeighbourhood(world, t);
+    world.setMesher(kind);
+    Chunk chunk = MakeChunk(t, {0, 0, 0});
+    WorkResult mesh;
+    size_t quads = 0;
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        mesh = WorkResult();
+        world.generateChunkMesh({0, 0, 0}, chunk, mesh);
+        quads += QuadCount(mesh);
+        bytes += MeshBytes(mesh);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    BenchResult r;
+    r.name = std::string("generateChunkMesh/") + (kind == MesherKind::Binary ? "binary/" : "reference/") + TerrainName(t);
+    r.nsPerChunk = ns / iterations;
+    r.quadsPerChunk = static_cast<double>(quads) / iterations;
+    r.bytesPerChunk = static_cast<double>(bytes) / iterations;
+    return r;
+}
+
+static BenchResult BenchSlices(World& world, Terrain t, int iterations) {
+    StoreNeighbourhood(world, t);
+    Chunk chunk = MakeChunk(t, {0, 0, 0});
+    std::array<Chunk, 6> neighbours;
+    for (int d = 0; d < 6; ++d) {
+        glm::ivec3 c(0);
+        c[d / 2] = (d % 2 == 0) ? 1 : -1;
+        neighbours[d] = MakeChunk(t, c);
+    }
+    std::array<const Chunk*, 6> neighbourPtrs;
+    for (int d = 0; d < 6; ++d) neighbourPtrs[d] = &neighbours[d];
+    PaddedChunk padded;
+    padded.gather(chunk, neighbourPtrs);
+    WorkResult mesh;
+    size_t quads = 0;
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        mesh = WorkResult();
+        for (int d = 0; d < 6; ++d) {
+            for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
+                world.greedyMeshSlice(padded, fixed, static_cast<direction>(d), {0, 0, 0}, mesh);
+            }
+        }
+        quads += QuadCount(mesh);
+        bytes += MeshBytes(mesh);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    BenchResult r;
+    r.name = std::string("greedyMeshSlice/") + TerrainName(t);
+    r.nsPerChunk = ns / iterations;
+    r.quadsPerChunk = static_cast<double>(quads) / iterations;
+    r.bytesPerChunk = static_cast<double>(bytes) / iterations;
+    return r;
+}
+
+// setBlocks samples the real noise terrain. Fresh columns pay for the
+// heightmap; the cached case reuses one column at increasing heights.
+static BenchResult BenchSetBlocks(World& world, bool freshColumns, int iterations) {
+    Chunk chunk;
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        glm::ivec3 coord = freshColumns ? glm::ivec3(i, 2, 1 << 16) : glm::ivec3(-1, i, -(1 << 16));
+        chunk.initToAir();
+        world.setBlocks(coord, chunk);
+        bytes += chunk.memoryUsage();
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    BenchResult r;
+    r.name = freshColumns ? "setBlocks/new-column" : "setBlocks/cached-column";
+    r.nsPerChunk = ns / iterations;
+    r.bytesPerChunk = static_cast<double>(bytes) / iterations;
+    return r;
+}
+
+// One chunk column of terrain noise (256 points, 7 octaves) per iteration,
+// through siv::PerlinNoise point by point or a HeightNoise kernel.
+static BenchResult BenchHeightmap(const siv::PerlinNoise& reference, HeightNoise::Kernel kernel, bool useReference, int iterations) {
+    constexpr int count = CHUNK_SIZE * CHUNK_SIZE;
+    HeightNoise noise(reference);
+    noise.SetKernel(kernel);
+    float xs[count], zs[count], out[count];
+    static volatile float sink;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (int c = 0; c < count; ++c) {
+            xs[c] = static_cast<float>(i * CHUNK_SIZE + c % CHUNK_SIZE) * 0.00008f;
+            zs[c] = static_cast<float>(c / CHUNK_SIZE) * 0.00008f;
+        }
+        if (useReference) {
+            for (int c = 0; c < count; ++c) out[c] = reference.octave2D(xs[c], zs[c], 7, 0.8f);
+        } else {
+            noise.Octave2D(xs, zs, out, count, 7, 0.8f);
+        }
+        sink = out[i % count];
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    // Reading the last value back keeps the stores, and so the noise, live.
+    if (!std::isfinite(sink)) std::cerr << "heightmap: noise returned " << sink << "\n";
+    BenchResult r;
+    r.name = std::string("heightmap/") + (useReference ? "siv-octave2D" : HeightNoise::KernelName(noise.ActiveKernel()));
+    r.nsPerChunk = ns / iterations;
+    return r;
+}
+
+// setBlocks plus meshing over the same cube of chunks ChunkManager
+// requests, with the uniform-chunk shortcut on or off. Heights are cached
+// by a warm-up pass so both runs measure only fill and mesh work.
+static BenchResult BenchGenerate(World& world, bool shortcut, int radius) {
+    const glm::ivec3 centre(1 << 12, 2, 0);
+    std::vector<glm::ivec3> coords;
+    for (int dx = -radius; dx <= radius; ++dx)
+        for (int dy = -radius; dy <= radius; ++dy)
+            for (int dz = -radius; dz <= radius; ++dz)
+                coords.push_back(centre + glm::ivec3(dx, dy, dz));
+    world.setChunkWindow(centre, radius + 1);
+    Chunk chunk;
+    for (const auto& c : coords) world.setBlocks(c, chunk);
+
+    world.setUniformShortcut(shortcut);
+    world.setMesher(MesherKind::Binary);
+    std::vector<Chunk> generated(coords.size());
+    size_t quads = 0;
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < coords.size(); ++i) {
+        world.setBlocks(coords[i], generated[i]);
+        world.storeChunk(coords[i], generated[i]);
+    }
+    for (size_t i = 0; i < coords.size(); ++i) {
+        WorkResult mesh;
+        world.generateChunkMesh(coords[i], generated[i], mesh);
+        quads += QuadCount(mesh);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    world.setUniformShortcut(true);
+    for (const auto& c : generated) bytes += c.memoryUsage();
+    BenchResult r;
+    r.name = std::string("generate/shortcut-") + (shortcut ? "on" : "off");
+    r.nsPerChunk = ns / coords.size();
+    r.quadsPerChunk = static_cast<double>(quads) / coords.size();
+    r.bytesPerChunk = static_cast<double>(bytes) / coords.size();
+    return r;
+}
+
+static BenchResult BenchMerge(World& world, int chunkCount, int iterations) {
+    world.setKeepMeshCopies(true);
+    StoreNeighbourhood(world, Terrain::Noisy);
+    Chunk chunk = MakeChunk(Terrain::Noisy, {0, 0, 0});
+    WorkResult mesh;
+    world.generateChunkMesh({0, 0, 0}, chunk, mesh);
+    for (int i = 0; i < chunkCount; ++i) {
+        WorkResult copy = mesh;
+        copy.coord = glm::ivec3(i, 100, 0);
+        world.storeMesh(std::move(copy));
+    }
+    std::vector<PackedVertex> vertices;
+    std::vector<GLuint> indices;
+    std::vector<PackedQuad> quads;
+    std::vector<DrawElementsCommand> commands;
+    size_t bytes = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        world.fetchMergedMesh(vertices, indices, quads, commands);
+        bytes += vertices.size() * sizeof(PackedVertex) + indices.size() * sizeof(GLuint) + quads.size() * sizeof(PackedQuad);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    world.setKeepMeshCopies(false);
+    BenchResult r;
+    r.name = "fetchMergedMesh/" + std::to_string(chunkCount) + "-chunks";
+    r.nsPerChunk = ns / (static_cast<double>(iterations) * chunkCount);
+    r.quadsPerChunk = static_cast<double>(QuadCount(mesh));
+    r.bytesPerChunk = static_cast<double>(bytes) / (static_cast<double>(iterations) * chunkCount);
+    return r;
+}
+
+// A camera two blocks above the terrain at (x, z). Most of a render cube
+// around a camera far above or below the surface is uniform and finishes
+// at once, which would leave only the shortcut to measure.
+static glm::vec3 OnGround(const World& world, glm::vec2 xz) {
+    int ground[1];
+    world.sampleHeights(glm::ivec2(glm::floor(xz)), 1, glm::ivec2(1), ground);
+    return glm::vec3(xz.x, static_cast<float>(ground[0]) + 2.0f, xz.y);
+}
+
+// Full ChunkManager -> job system -> mesh pipeline on a cold world around
+// a camera on the ground, for 1..hardware_concurrency threads (workers
+// plus the waiting main thread).
+static std::vector<BenchResult> BenchScaling(MeshFormat format, int radius) {
+    std::vector<BenchResult> results;
+    int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        World world(format, threads - 1);
+        glm::vec3 camera = OnGround(world, glm::vec2(0.5f));
+        std::vector<WorkResult> finished;
+        std::vector<glm::ivec3> evicted;
+        auto start = Clock::now();
+        world.ChunkManager(camera, radius);
+        while (world.pendingChunkCount() > 0) {
+            world.scheduleChunks(camera, glm::vec3(0.0f, 0.0f, -1.0f));
+            // With no workers the main thread is the only one running jobs.
+            if (threads == 1) world.waitForJobs();
+            else std::this_thread::yield();
+        }
+        world.waitForJobs();
+        world.fetchMeshUpdates(finished, evicted);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        size_t quads = 0;
+        for (const auto& mesh : finished) quads += QuadCount(mesh);
+        BenchResult r;
+        r.name = "pipeline/threads-" + std::to_string(threads);
+        r.nsPerChunk = seconds * 1e9 / finished.size();
+        r.quadsPerChunk = static_cast<double>(quads) / finished.size();
+        results.push_back(r);
+    }
+    return results;
+}
+
+struct StartupResult {
+    std::string name;
+    double msToNearTerrain = 0.0;
+    // Chunks with faces near the camera that the run waits for.
+    size_t nearChunks = 0;
+    size_t chunksBuilt = 0;
+};
+
+// Chunks within `nearRadius` of the camera chunk whose finished mesh has
+// quads, found by building the region once to completion.
+static std::set<std::tuple<int, int, int>> VisibleNearChunks(MeshFormat format, glm::vec3 camera, int radius, int nearRadius) {
+    World world(format, 0);
+    glm::ivec3 cameraChunk = glm::floor(camera / static_cast<float>(CHUNK_SIZE));
+    world.ChunkManager(camera, radius);
+    while (world.pendingChunkCount() > 0) {
+        world.scheduleChunks(camera, glm::vec3(0.0f, 0.0f, -1.0f));
+        world.waitForJobs();
+    }
+    std::vector<WorkResult> finished;
+    std::vector<glm::ivec3> evicted;
+    world.fetchMeshUpdates(finished, evicted);
+    std::set<std::tuple<int, int, int>> visible;
+    for (const auto& mesh : finished) {
+        glm::ivec3 d = glm::abs(mesh.coord - cameraChunk);
+        if (std::max({d.x, d.y, d.z}) <= nearRadius && QuadCount(mesh) > 0) visible.insert({mesh.coord.x, mesh.coord.y, mesh.coord.z});
+    }
+    return visible;
+}
+
+// How long until every chunk with faces within two chunks of a camera on
+// the ground has a mesh, starting from an empty world, with and without
+// priority scheduling.
+static StartupResult BenchStartup(MeshFormat format, bool prioritized, int radius) {
+    glm::vec3 camera;
+    {
+        World probe(format, 0);
+        camera = OnGround(probe, glm::vec2(0.5f));
+    }
+    glm::vec3 front(0.0f, 0.0f, -1.0f);
+    const std::set<std::tuple<int, int, int>> nearVisible = VisibleNearChunks(format, camera, radius, 2);
+    World world(format, 0);
+    world.setPrioritizedScheduling(prioritized);
+    std::set<std::tuple<int, int, int>> nearDone;
+    StartupResult r;
+    r.name = prioritized ? "startup/priority" : "startup/loop-order";
+    r.nearChunks = nearVisible.size();
+    std::vector<WorkResult> finished;
+    std::vector<glm::ivec3> evicted;
+    auto start = Clock::now();
+    world.ChunkManager(camera, radius);
+    while (nearDone.size() < nearVisible.size() && world.pendingChunkCount() > 0) {
+        world.scheduleChunks(camera, front);
+        world.waitForJobs();
+        finished.clear();
+        world.fetchMeshUpdates(finished, evicted);
+        for (const auto& mesh : finished) {
+            std::tuple<int, int, int> key{mesh.coord.x, mesh.coord.y, mesh.coord.z};
+            if (QuadCount(mesh) > 0 && nearVisible.count(key)) nearDone.insert(key);
+        }
+        r.chunksBuilt += finished.size();
+    }
+    r.msToNearTerrain = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return r;
+}
+
+struct FlyResult {
+    std::string name;
+    size_t meshed = 0;
+    // Meshes handed over after the camera had already left them behind.
+    size_t late = 0;
+    WorkCounters counters;
+    ChunkStateTable::Counts states{};
+};
+
+// Camera crosses a chunk every 2 ms frame along the terrain surface,
+// faster than the workers can keep up with, and the scheduler runs as in
+// Application. Run with the epoch check on and off: the difference in
+// generations and late meshes is the work the check saves. Timing
+// dependent, so the counts vary from run to run.
+static FlyResult BenchFlyThrough(MeshFormat format, int radius, int frames, bool staleChecks) {
+    int workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    World world(format, workers);
+    world.setStaleChecks(staleChecks);
+    glm::vec3 camera = OnGround(world, glm::vec2(0.5f));
+    glm::vec3 front(1.0f, 0.0f, 0.0f);
+    std::vector<WorkResult> finished;
+    std::vector<glm::ivec3> evicted;
+    FlyResult r;
+    r.name = staleChecks ? "fly/epoch-check" : "fly/no-check";
+    auto collect = [&]() {
+        finished.clear();
+        world.fetchMeshUpdates(finished, evicted);
+        glm::ivec3 cameraChunk = glm::floor(camera / static_cast<float>(CHUNK_SIZE));
+        for (const auto& mesh : finished) {
+            glm::ivec3 d = glm::abs(mesh.coord - cameraChunk);
+            if (std::max({d.x, d.y, d.z}) > radius) r.late++;
+        }
+        r.meshed += finished.size();
+    };
+    for (int frame = 0; frame < frames; ++frame) {
+        world.ChunkManager(camera, radius);
+        world.scheduleChunks(camera, front);
+        collect();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        camera = OnGround(world, glm::vec2(camera.x + CHUNK_SIZE, camera.z));
+    }
+    world.waitForJobs();
+    collect();
+    r.counters = world.getWorkCounters();
+    r.states = world.getChunkStateCounts();
+    return r;
+}
+
+struct LodResult {
+    double msToBuild = 0.0;
+    size_t rebuiltAfterStep = 0;
+    std::array<size_t, LOD_LEVELS> meshes{};
+    std::array<size_t, LOD_LEVELS> quads{};
+    std::array<size_t, LOD_LEVELS> bytes{};
+};
+
+// Full-resolution cube plus three LOD rings around a fixed camera on the
+// ground, built to completion on the calling thread, then how many far
+// columns one chunk of camera movement sends back for rebuilding.
+static LodResult BenchLod(MeshFormat format, int radius, int lodRadius) {
+    World world(format, 0);
+    world.setLodLevels(LodRings::MaxLevel, lodRadius);
+    glm::vec3 camera = OnGround(world, glm::vec2(0.5f));
+    glm::vec3 front(1.0f, 0.0f, 0.0f);
+    std::vector<WorkResult> finished;
+    std::vector<glm::ivec3> evicted;
+    std::vector<glm::ivec4> lodEvicted;
+    LodResult r;
+    auto start = Clock::now();
+    world.ChunkManager(camera, radius);
+    while (world.pendingChunkCount() > 0 || world.pendingLodColumnCount() > 0) {
+        world.scheduleChunks(camera, front);
+        world.waitForJobs();
+    }
+    world.fetchMeshUpdates(finished, evicted);
+    world.fetchLodUpdates(finished, lodEvicted);
+    r.msToBuild = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    for (const auto& mesh : finished) {
+        r.meshes[mesh.lod]++;
+        r.quads[mesh.lod] += QuadCount(mesh);
+        r.bytes[mesh.lod] += MeshBytes(mesh);
+    }
+    camera.x += CHUNK_SIZE;
+    world.ChunkManager(camera, radius);
+    r.rebuiltAfterStep = world.pendingLodColumnCount();
+    return r;
+}
+
+struct RegionResult {
+    std::string name;
+    size_t chunksBuilt = 0;
+    size_t quads = 0;
+    double msToBuild = 0.0;
+    // Same upward faces as the unclamped version of the shape.
+    bool sameSurface = true;
+};
+
+// Builds one region shape to completion around a camera just above the
+// terrain and collects the terrain's top faces it drew, in block
+// coordinates. Lids where a region's vertical radius cuts through solid
+// ground are left out; clamping to the terrain rightly skips those.
+static RegionResult BenchRegion(MeshFormat format, RegionShape shape, int radius, int verticalRadius, bool clamp,
+                                std::set<std::tuple<int, int, int>>& surface) {
+    World world(format, 0);
+    world.setRenderRegion(shape, verticalRadius, clamp);
+    glm::vec3 front(1.0f, 0.0f, 0.0f);
+    glm::vec3 camera = OnGround(world, glm::vec2(0.5f));
+    std::vector<WorkResult> finished;
+    std::vector<glm::ivec3> evicted;
+    RegionResult r;
+    r.name = std::string(shape == RegionShape::Cube ? "cube" : shape == RegionShape::Cylinder ? "cylinder" : "ellipsoid")
+           + (clamp ? "+terrain" : "");
+    auto start = Clock::now();
+    world.ChunkManager(camera, radius);
+    while (world.pendingChunkCount() > 0) {
+        world.scheduleChunks(camera, front);
+        world.waitForJobs();
+    }
+    world.fetchMeshUpdates(finished, evicted);
+    r.msToBuild = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    ChunkStateTable::Counts states = world.getChunkStateCounts();
+    for (int i = 0; i < ChunkStateTable::StateCount; ++i) r.chunksBuilt += states[i];
+    const int side = (2 * radius + 1) * CHUNK_SIZE;
+    const glm::ivec2 origin((glm::ivec2(glm::floor(glm::vec2(camera.x, camera.z) / static_cast<float>(CHUNK_SIZE))) - radius) * CHUNK_SIZE);
+    std::vector<int> heights(static_cast<size_t>(side) * side);
+    world.sampleHeights(origin, 1, glm::ivec2(side), heights.data());
+    surface.clear();
+    for (const auto& mesh : finished) {
+        r.quads += QuadCount(mesh);
+        for (const auto& cell : Coverage(mesh)) {
+            if (std::get<0>(cell) != static_cast<int>(direction::POSITIVE_Y)) continue;
+            glm::ivec3 block = mesh.coord * CHUNK_SIZE + glm::ivec3(std::get<1>(cell), std::get<2>(cell), std::get<3>(cell));
+            glm::ivec2 local = glm::ivec2(block.x, block.z) - origin;
+            if (block.y != heights[local.x + local.y * side] - 1) continue;
+            surface.insert({block.x, block.y, block.z});
+        }
+    }
+    return r;
+}
+
+static std::vector<RegionResult> BenchRegions(MeshFormat format, int radius) {
+    std::vector<RegionResult> results;
+    const RegionShape shapes[] = {RegionShape::Cube, RegionShape::Cylinder, RegionShape::Ellipsoid};
+    for (RegionShape shape : shapes) {
+        int vertical = shape == RegionShape::Cube ? radius : radius / 2;
+        std::set<std::tuple<int, int, int>> full, clamped;
+        results.push_back(BenchRegion(format, shape, radius, vertical, false, full));
+        results.push_back(BenchRegion(format, shape, radius, vertical, true, clamped));
+        results.back().sameSurface = full == clamped;
+    }
+    return results;
+}
+
+struct ClipmapResult {
+    double msToFill = 0.0;
+    size_t samplesToFill = 0;
+    size_t frames = 0;
+    double meanMsPerFrame = 0.0;
+    double maxMsPerFrame = 0.0;
+    size_t maxSamplesPerFrame = 0;
+    // Heights assembled from the incremental updates match a fresh sample.
+    bool intact = true;
+};
+
+// Fills a clipmap, then flies the camera diagonally and times each frame's
+// incremental update. The updates are applied to CPU copies of the height
+// textures, which must end up equal to resampling every level from scratch.
+static ClipmapResult BenchClipmap(int frames, float blocksPerFrame) {
+    World world(MeshFormat::PulledQuads, 0);
+    HeightSampler sampler = [&world](glm::ivec2 origin, int stride, glm::ivec2 size, int* heights) {
+        world.sampleHeights(origin, stride, size, heights);
+    };
+    Clipmap clipmap(sampler);
+    const int size = clipmap.Size();
+    std::vector<std::vector<float>> textures(clipmap.Levels(), std::vector<float>(static_cast<size_t>(size) * size));
+    std::vector<ClipmapUpdate> updates;
+    auto apply = [&]() {
+        clipmap.TakeUpdates(updates);
+        for (const auto& u : updates) {
+            for (int z = 0; z < u.size.y; ++z) {
+                for (int x = 0; x < u.size.x; ++x) {
+                    textures[u.level][(u.texel.x + x) + (u.texel.y + z) * size] = u.heights[x + z * u.size.x];
+                }
+            }
+        }
+        updates.clear();
+    };
+
+    ClipmapResult r;
+    glm::vec2 camera(0.0f);
+    auto start = Clock::now();
+    clipmap.Update(camera);
+    r.msToFill = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    r.samplesToFill = clipmap.SamplesTaken();
+    apply();
+    double totalMs = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        camera += glm::vec2(blocksPerFrame, blocksPerFrame * 0.5f);
+        size_t before = clipmap.SamplesTaken();
+        auto frameStart = Clock::now();
+        clipmap.Update(camera);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+        totalMs += ms;
+        r.maxMsPerFrame = std::max(r.maxMsPerFrame, ms);
+        r.maxSamplesPerFrame = std::max(r.maxSamplesPerFrame, clipmap.SamplesTaken() - before);
+        apply();
+    }
+    r.frames = static_cast<size_t>(frames);
+    r.meanMsPerFrame = totalMs / std::max(1, frames);
+
+    std::vector<int> fresh(static_cast<size_t>(size) * size);
+    for (int level = 0; level < clipmap.Levels(); ++level) {
+        glm::ivec2 origin = clipmap.Origin(level);
+        glm::ivec2 texelOrigin = clipmap.TexelOrigin(level);
+        world.sampleHeights(origin * clipmap.Spacing(level), clipmap.Spacing(level), glm::ivec2(size), fresh.data());
+        for (int z = 0; z < size; ++z) {
+            for (int x = 0; x < size; ++x) {
+                int texel = (texelOrigin.x + x) % size + ((texelOrigin.y + z) % size) * size;
+                if (textures[level][texel] != static_cast<float>(fresh[x + z * size])) r.intact = false;
+            }
+        }
+    }
+    return r;
+}
+
+// Stands in for the GL upload backend. Staging copies only land in the
+// target buffers once the simulated GPU, running `latency` frames behind,
+// passes their fence, so reusing staging space too early corrupts the
+// output and shows up in the final comparison.
+class MockUploadBackend : public UploadBackend {
+private:
+    struct Command {
+        uint64_t fence;
+        UploadTarget target;
+        size_t destOffset;
+        size_t size;
+        size_t stagingOffset;
+        // Empty for staging copies.
+        std::vector<uint8_t> payload;
+    };
+    std::vector<uint8_t> staging;
+    std::deque<Command> commands;
+    std::vector<int> fenceFrames{0};
+    int frame = 0;
+    int latency;
+
+    std::vector<uint8_t>& Target(UploadTarget target) {
+        return target == UploadTarget::Vertices ? vertices : indices;
+    }
+    uint64_t GpuFence() const {
+        uint64_t done = 0;
+        while (done + 1 < fenceFrames.size() && fenceFrames[done + 1] + latency <= frame) ++done;
+        return done;
+    }
+    void Execute() {
+        uint64_t done = GpuFence();
+        while (!commands.empty() && commands.front().fence <= done) {
+            Command& c = commands.front();
+            std::vector<uint8_t>& target = Target(c.target);
+            const uint8_t* src = c.payload.empty() ? &staging[c.stagingOffset] : c.payload.data();
+            if (target.size() < c.destOffset + c.size) target.resize(c.destOffset + c.size);
+            std::memcpy(&target[c.destOffset], src, c.size);
+            commands.pop_front();
+        }
+    }
+public:
+    std::vector<uint8_t> vertices;
+    std::vector<uint8_t> indices;
+
+    MockUploadBackend(size_t capacity, int latency) : staging(capacity), latency(latency) {}
+    void WriteStaging(size_t offset, const void* data, size_t bytes) override {
+        std::memcpy(&staging[offset], data, bytes);
+    }
+    void CopyStaging(UploadTarget target, size_t stagingOffset, size_t destOffset, size_t bytes) override {
+        commands.push_back({fenceFrames.size(), target, destOffset, bytes, stagingOffset, {}});
+    }
+    void WriteDirect(UploadTarget target, size_t destOffset, const void* data, size_t bytes) override {
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        commands.push_back({fenceFrames.size(), target, destOffset, bytes, 0, std::vector<uint8_t>(src, src + bytes)});
+    }
+    uint64_t InsertFence() override {
+        fenceFrames.push_back(frame);
+        return fenceFrames.size() - 1;
+    }
+    bool IsSignaled(uint64_t fence) override {
+        Execute();
+        return fence <= GpuFence();
+    }
+    void DeleteFence(uint64_t) override {}
+    void AdvanceFrame() {
+        ++frame;
+        Execute();
+    }
+    // Lets every queued command complete.
+    void Drain() {
+        frame += latency + 1;
+        InsertFence();
+        frame += latency + 1;
+        Execute();
+    }
+};
+
+struct UploadResult {
+    std::string name;
+    size_t frames = 0;
+    UploadStats stats;
+    bool intact = false;
+};
+
+// Meshes for a cube of noisy chunks, roughly what a chunk crossing into
+// rough terrain hands the upload stage.
+static std::vector<WorkResult> BurstMeshes(MeshFormat format, int radius) {
+    World world(format, 0);
+    world.setChunkWindow({0, 0, 0}, radius + 1);
+    std::vector<glm::ivec3> coords;
+    for (int dx = -radius; dx <= radius; ++dx)
+        for (int dy = -radius; dy <= radius; ++dy)
+            for (int dz = -radius; dz <= radius; ++dz)
+                coords.push_back(glm::ivec3(dx, dy, dz));
+    std::vector<Chunk> chunks;
+    for (const auto& c : coords) {
+        chunks.push_back(MakeChunk(Terrain::Noisy, c));
+        world.storeChunk(c, chunks.back());
+    }
+    std::vector<WorkResult> meshes;
+    for (size_t i = 0; i < coords.size(); ++i) {
+        WorkResult mesh;
+        mesh.coord = coords[i];
+        world.generateChunkMesh(coords[i], chunks[i], mesh);
+        if (!mesh.quads.empty() || !mesh.indices.empty()) meshes.push_back(std::move(mesh));
+    }
+    return meshes;
+}
+
+// Feeds two bursts of meshes (a chunk crossing, then the same chunks
+// remeshed) through StagingUploader the way ChunkMeshRegistry does, one
+// simulated frame at a time, and checks the target buffers at the end.
+static UploadResult BenchUpload(const std::vector<WorkResult>& meshes, MeshFormat format, size_t frameBudget) {
+    constexpr size_t stagingCapacity = 8 << 20;
+    constexpr int gpuLatency = 2;
+    constexpr size_t secondBurstFrame = 40;
+    MockUploadBackend backend(stagingCapacity, gpuLatency);
+    StagingUploader uploader(backend, stagingCapacity, frameBudget);
+    BufferArena vertexArena(64 << 20);
+    BufferArena indexArena(64 << 20);
+    std::unordered_map<glm::ivec3, std::pair<ArenaRange, ArenaRange>> placed;
+    std::deque<const WorkResult*> queue;
+    bool pulled = (format == MeshFormat::PulledQuads);
+
+    UploadResult r;
+    r.name = frameBudget == SIZE_MAX ? "upload/unbudgeted" : "upload/budget-" + std::to_string(frameBudget >> 10) + "KiB";
+    for (size_t frame = 0; frame < secondBurstFrame || !queue.empty(); ++frame) {
+        if (frame == 0 || frame == secondBurstFrame) {
+            for (const auto& mesh : meshes) queue.push_back(&mesh);
+        }
+        uploader.BeginFrame();
+        while (!queue.empty()) {
+            const WorkResult& mesh = *queue.front();
+            size_t vertexBytes = pulled ? mesh.quads.size() * sizeof(PackedQuad) : mesh.vertices.size() * sizeof(PackedVertex);
+            size_t indexBytes = pulled ? 0 : mesh.indices.size() * sizeof(GLuint);
+            if (!uploader.CanUpload(vertexBytes + indexBytes)) break;
+            auto it = placed.find(mesh.coord);
+            if (it != placed.end()) {
+                vertexArena.Free(it->second.first);
+                indexArena.Free(it->second.second);
+            }
+            ArenaRange v, ix;
+            vertexArena.Allocate(vertexBytes, v);
+            if (pulled) {
+                uploader.Upload(UploadTarget::Vertices, v.offset, mesh.quads.data(), vertexBytes);
+            } else {
+                indexArena.Allocate(indexBytes, ix);
+                uploader.Upload(UploadTarget::Vertices, v.offset, mesh.vertices.data(), vertexBytes);
+                uploader.Upload(UploadTarget::Indices, ix.offset, mesh.indices.data(), indexBytes);
+            }
+            placed[mesh.coord] = {v, ix};
+            queue.pop_front();
+        }
+        uploader.EndFrame();
+        backend.AdvanceFrame();
+        r.frames = frame + 1;
+    }
+    backend.Drain();
+    r.stats = uploader.Stats();
+
+    r.intact = true;
+    for (const auto& mesh : meshes) {
+        const auto& ranges = placed[mesh.coord];
+        const void* vertexData = pulled ? static_cast<const void*>(mesh.quads.data()) : static_cast<const void*>(mesh.vertices.data());
+        if (std::memcmp(&backend.vertices[ranges.first.offset], vertexData, ranges.first.size) != 0) r.intact = false;
+        if (!pulled && std::memcmp(&backend.indices[ranges.second.offset], mesh.indices.data(), ranges.second.size) != 0) r.intact = false;
+    }
+    return r;
+}
+
+struct PacingResult {
+    std::string name;
+    double framesPerBurst = 0.0;
+    FrameStats stats;
+};
+
+// Frame times under a simple cost model, a fixed base cost plus a cost per
+// uploaded MiB, while the camera crosses into a fresh burst of meshes every
+// half second. Unbudgeted uploads each burst in one frame; adaptive sizes
+// the upload budget from FrameBudget as Application does. Only the relative
+// spikes are meaningful.
+static PacingResult BenchPacing(const std::vector<WorkResult>& meshes, MeshFormat format, bool adaptive) {
+    constexpr double baseMs = 8.0;
+    constexpr double msPerMiB = 20.0;
+    constexpr size_t frames = 1800;
+    constexpr size_t crossingInterval = 30;
+    bool pulled = (format == MeshFormat::PulledQuads);
+    FrameBudget budget;
+    std::deque<size_t> queue;
+    size_t drainFrames = 0;
+    size_t crossings = 0;
+    PacingResult r;
+    r.name = adaptive ? "pacing/adaptive" : "pacing/unbudgeted";
+    for (size_t frame = 0; frame < frames; ++frame) {
+        if (frame % crossingInterval == 0) {
+            for (const auto& mesh : meshes) {
+                queue.push_back(pulled ? mesh.quads.size() * sizeof(PackedQuad)
+                                       : mesh.vertices.size() * sizeof(PackedVertex) + mesh.indices.size() * sizeof(GLuint));
+            }
+            crossings++;
+        }
+        size_t limit = adaptive ? budget.UploadBytes() : SIZE_MAX;
+        size_t bytes = 0;
+        // Same rule as StagingUploader: the first upload of a frame always goes.
+        while (!queue.empty() && (bytes == 0 || bytes + queue.front() <= limit)) {
+            bytes += queue.front();
+            queue.pop_front();
+        }
+        if (bytes > 0) drainFrames++;
+        double ms = baseMs + msPerMiB * static_cast<double>(bytes) / (1 << 20);
+        budget.EndFrame(ms / 1000.0, !queue.empty());
+    }
+    r.framesPerBurst = static_cast<double>(drainFrames) / crossings;
+    r.stats = budget.Stats();
+    return r;
+}
+
+// Every available HeightNoise kernel against siv::PerlinNoise::octave2D, at
+// terrain scale and at a coarser scale that crosses many lattice cells.
+static bool VerifyHeightNoise() {
+    const siv::PerlinNoise reference(12345u);
+    const HeightNoise::Kernel kernels[] = {HeightNoise::Kernel::Scalar, HeightNoise::Kernel::Sse41, HeightNoise::Kernel::Avx2};
+    const float scales[] = {0.00008f, 0.013f};
+    constexpr int count = 4099;
+    std::vector<float> xs(count), zs(count), out(count);
+    bool ok = true;
+    for (HeightNoise::Kernel k : kernels) {
+        if (k > HeightNoise::BestKernel()) continue;
+        HeightNoise noise(reference);
+        noise.SetKernel(k);
+        float maxError = 0.0f;
+        for (float scale : scales) {
+            for (int i = 0; i < count; ++i) {
+                xs[i] = static_cast<float>(static_cast<int>(Hash2(i, 1) % 200000) - 100000) * scale;
+                zs[i] = static_cast<float>(static_cast<int>(Hash2(i, 2) % 200000) - 100000) * scale;
+            }
+            noise.Octave2D(xs.data(), zs.data(), out.data(), count, 7, 0.8f);
+            for (int i = 0; i < count; ++i) {
+                maxError = std::max(maxError, std::abs(out[i] - reference.octave2D(xs[i], zs[i], 7, 0.8f)));
+            }
+        }
+        bool same = maxError < 1e-4f;
+        std::cerr << "verify heightmap/" << HeightNoise::KernelName(k) << ": " << (same ? "ok" : "MISMATCH")
+                  << " (max error " << maxError << ")\n";
+        ok = ok && same;
+    }
+    return ok;
+}
+
+static bool Verify(World& world) {
+    const Terrain terrains[] = {Terrain::Flat, Terrain::Noisy, Terrain::Checkerboard, Terrain::Empty, Terrain::Full};
+    bool ok = true;
+    for (Terrain t : terrains) {
+        StoreNeighbourhood(world, t);
+        Chunk chunk = MakeChunk(t, {0, 0, 0});
+        WorkResult reference, binary;
+        world.setMesher(MesherKind::Reference);
+        world.generateChunkMesh({0, 0, 0}, chunk, reference);
+        world.setMesher(MesherKind::Binary);
+        world.generateChunkMesh({0, 0, 0}, chunk, binary);
+        bool same = Coverage(reference) == Coverage(binary);
+        std::cerr << "verify " << TerrainName(t) << ": " << (same ? "ok" : "MISMATCH") << "\n";
+        ok = ok && same;
+    }
+    return VerifyHeightNoise() && ok;
+}
+
+static void PrintText(const std::vector<BenchResult>& results, const std::vector<StartupResult>& startup, const std::vector<FlyResult>& fly,
+                      const LodResult& lod, const ClipmapResult& clip, const std::vector<RegionResult>& regions,
+                      const std::vector<UploadResult>& uploads, const std::vector<PacingResult>& pacing) {
+    std::cout << "benchmark                                  ns/chunk   chunks/s   quads/chunk   bytes/chunk\n";
+    for (const auto& r : results) {
+        std::string name = r.name;
+        name.resize(40, ' ');
+        std::cout << name << " " << r.nsPerChunk << "   " << 1e9 / r.nsPerChunk << "   " << r.quadsPerChunk << "   " << r.bytesPerChunk << "\n";
+    }
+    std::cout << "\nstartup                                    ms to near terrain   near chunks   chunks built\n";
+    for (const auto& s : startup) {
+        std::string name = s.name;
+        name.resize(40, ' ');
+        std::cout << name << " " << s.msToNearTerrain << "   " << s.nearChunks << "   " << s.chunksBuilt << "\n";
+    }
+    std::cout << "\nfly-through                                generations   meshed   late   cancelled   wasted generations   wasted meshes   remeshes\n";
+    for (const auto& f : fly) {
+        std::string name = f.name;
+        name.resize(40, ' ');
+        std::cout << name << " " << f.counters.generations << "   " << f.meshed << "   " << f.late << "   " << f.counters.cancelled << "   "
+                  << f.counters.wastedGenerations << "   " << f.counters.wastedMeshes << "   " << f.counters.remeshes << "\n";
+    }
+    for (const auto& f : fly) {
+        std::cout << "chunk states after " << f.name << ":";
+        for (int i = 0; i < ChunkStateTable::StateCount; ++i) {
+            std::cout << " " << ChunkStateName(static_cast<ChunkState>(i)) << " " << f.states[i];
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\nlod: built in " << lod.msToBuild << " ms, " << lod.rebuiltAfterStep << " far columns rebuilt after a one-chunk step\n";
+    std::cout << "level   meshes   quads   KiB\n";
+    for (int level = 0; level < LOD_LEVELS; ++level) {
+        std::cout << level << "   " << lod.meshes[level] << "   " << lod.quads[level] << "   " << (lod.bytes[level] >> 10) << "\n";
+    }
+    std::cout << "\nclipmap: filled " << clip.samplesToFill << " heights in " << clip.msToFill << " ms; " << clip.frames
+              << " moving frames at " << clip.meanMsPerFrame << " ms mean, " << clip.maxMsPerFrame << " ms max, "
+              << clip.maxSamplesPerFrame << " heights max per frame, " << (clip.intact ? "intact" : "NOT INTACT") << "\n";
+    std::cout << "\nregion                                     chunks built   quads   ms to build   same surface\n";
+    for (const auto& g : regions) {
+        std::string name = g.name;
+        name.resize(40, ' ');
+        std::cout << name << " " << g.chunksBuilt << "   " << g.quads << "   " << g.msToBuild << "   " << (g.sameSurface ? "yes" : "NO") << "\n";
+    }
+    std::cout << "\nupload                                     frames   max KiB/frame   budget deferrals   ring-full deferrals   direct writes   intact\n";
+    for (const auto& u : uploads) {
+        std::string name = u.name;
+        name.resize(40, ' ');
+        std::cout << name << " " << u.frames << "   " << (u.stats.maxFrameBytes >> 10) << "   " << u.stats.budgetDeferrals << "   "
+                  << u.stats.ringFullDeferrals << "   " << u.stats.directWrites << "   " << (u.intact ? "yes" : "NO") << "\n";
+    }
+    std::cout << "\npacing                                     p50 ms   p99 ms   max ms   frames per burst\n";
+    for (const auto& p : pacing) {
+        std::string name = p.name;
+        name.resize(40, ' ');
+        std::cout << name << " " << p.stats.p50Ms << "   " << p.stats.p99Ms << "   " << p.stats.maxMs << "   " << p.framesPerBurst << "\n";
+    }
+}
+
+static void PrintJson(const std::vector<BenchResult>& results, const std::vector<StartupResult>& startup, const std::vector<FlyResult>& fly,
+                      const LodResult& lod, const ClipmapResult& clip, const std::vector<RegionResult>& regions,
+                      const std::vector<UploadResult>& uploads, const std::vector<PacingResult>& pacing) {
+    std::cout << "{\n  \"chunk_size\": " << CHUNK_SIZE << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::cout << "    {\"name\": \"" << r.name << "\", \"ns_per_chunk\": " << r.nsPerChunk
+                  << ", \"chunks_per_second\": " << 1e9 / r.nsPerChunk
+                  << ", \"quads_per_chunk\": " << r.quadsPerChunk
+                  << ", \"bytes_per_chunk\": " << r.bytesPerChunk << "}"
+                  << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ],\n  \"startup\": [\n";
+    for (size_t i = 0; i < startup.size(); ++i) {
+        const auto& s = startup[i];
+        std::cout << "    {\"name\": \"" << s.name << "\", \"ms_to_near_terrain\": " << s.msToNearTerrain
+                  << ", \"near_chunks\": " << s.nearChunks
+                  << ", \"chunks_built\": " << s.chunksBuilt << "}"
+                  << (i + 1 < startup.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ],\n  \"fly_through\": [\n";
+    for (size_t f = 0; f < fly.size(); ++f) {
+        const auto& run = fly[f];
+        std::cout << "    {\"name\": \"" << run.name << "\", \"generations\": " << run.counters.generations
+                  << ", \"meshed\": " << run.meshed
+                  << ", \"late\": " << run.late
+                  << ", \"cancelled\": " << run.counters.cancelled
+                  << ", \"wasted_generations\": " << run.counters.wastedGenerations
+                  << ", \"wasted_meshes\": " << run.counters.wastedMeshes
+                  << ", \"remeshes\": " << run.counters.remeshes << ", \"states\": {";
+        for (int i = 0; i < ChunkStateTable::StateCount; ++i) {
+            std::cout << (i ? ", " : "") << "\"" << ChunkStateName(static_cast<ChunkState>(i)) << "\": " << run.states[i];
+        }
+        std::cout << "}}" << (f + 1 < fly.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ],\n  \"lod\": {\"ms_to_build\": " << lod.msToBuild
+              << ", \"rebuilt_after_step\": " << lod.rebuiltAfterStep << ", \"levels\": [";
+    for (int level = 0; level < LOD_LEVELS; ++level) {
+        std::cout << (level ? ", " : "") << "{\"meshes\": " << lod.meshes[level] << ", \"quads\": " << lod.quads[level]
+                  << ", \"bytes\": " << lod.bytes[level] << "}";
+    }
+    std::cout << "]},\n  \"clipmap\": {\"ms_to_fill\": " << clip.msToFill
+              << ", \"samples_to_fill\": " << clip.samplesToFill
+              << ", \"frames\": " << clip.frames
+              << ", \"mean_ms_per_frame\": " << clip.meanMsPerFrame
+              << ", \"max_ms_per_frame\": " << clip.maxMsPerFrame
+              << ", \"max_samples_per_frame\": " << clip.maxSamplesPerFrame
+              << ", \"intact\": " << (clip.intact ? "true" : "false") << "},\n  \"regions\": [\n";
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& g = regions[i];
+        std::cout << "    {\"name\": \"" << g.name << "\", \"chunks_built\": " << g.chunksBuilt
+                  << ", \"quads\": " << g.quads
+                  << ", \"ms_to_build\": " << g.msToBuild
+                  << ", \"same_surface\": " << (g.sameSurface ? "true" : "false") << "}"
+                  << (i + 1 < regions.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ],\n  \"upload\": [\n";
+    for (size_t i = 0; i < uploads.size(); ++i) {
+        const auto& u = uploads[i];
+        std::cout << "    {\"name\": \"" << u.name << "\", \"frames\": " << u.frames
+                  << ", \"max_frame_bytes\": " << u.stats.maxFrameBytes
+                  << ", \"budget_deferrals\": " << u.stats.budgetDeferrals
+                  << ", \"ring_full_deferrals\": " << u.stats.ringFullDeferrals
+                  << ", \"direct_writes\": " << u.stats.directWrites
+                  << ", \"intact\": " << (u.intact ? "true" : "false") << "}"
+                  << (i + 1 < uploads.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ],\n  \"pacing\": [\n";
+    for (size_t i = 0; i < pacing.size(); ++i) {
+        const auto& p = pacing[i];
+        std::cout << "    {\"name\": \"" << p.name << "\", \"p50_ms\": " << p.stats.p50Ms
+                  << ", \"p99_ms\": " << p.stats.p99Ms
+                  << ", \"max_ms\": " << p.stats.maxMs
+                  << ", \"frames_per_burst\": " << p.framesPerBurst << "}"
+                  << (i + 1 < pacing.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    bool verify = false;
+    bool scaling = false;
+    int iterations = 200;
+    MeshFormat format = MeshFormat::PulledQuads;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) json = true;
+        else if (std::strcmp(argv[i], "--verify") == 0) verify = true;
+        else if (std::strcmp(argv[i], "--scaling") == 0) scaling = true;
+        else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = (std::strcmp(argv[++i], "indexed") == 0) ? MeshFormat::IndexedVertices : MeshFormat::PulledQuads;
+        } else {
+            std::cerr << "usage: voxel_bench [--json] [--verify] [--scaling] [--iterations N] [--format pulled|indexed]\n";
+            return 2;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    World world(format, 0);
+    if (verify && !Verify(world)) return 1;
+
+    std::vector<BenchResult> results;
+    {
+        const siv::PerlinNoise reference(12345u);
+        results.push_back(BenchHeightmap(reference, HeightNoise::Kernel::Scalar, true, iterations));
+        results.push_back(BenchHeightmap(reference, HeightNoise::Kernel::Scalar, false, iterations));
+        if (HeightNoise::BestKernel() >= HeightNoise::Kernel::Sse41) {
+            results.push_back(BenchHeightmap(reference, HeightNoise::Kernel::Sse41, false, iterations));
+        }
+        if (HeightNoise::BestKernel() >= HeightNoise::Kernel::Avx2) {
+            results.push_back(BenchHeightmap(reference, HeightNoise::Kernel::Avx2, false, iterations));
+        }
+    }
+    results.push_back(BenchSetBlocks(world, true, iterations));
+    results.push_back(BenchSetBlocks(world, false, iterations));
+    results.push_back(BenchGenerate(world, false, 5));
+    results.push_back(BenchGenerate(world, true, 5));
+    const Terrain terrains[] = {Terrain::Flat, Terrain::Noisy, Terrain::Checkerboard, Terrain::Empty, Terrain::Full};
+    for (Terrain t : terrains) {
+        results.push_back(BenchMesh(world, t, MesherKind::Binary, iterations));
+        results.push_back(BenchMesh(world, t, MesherKind::Reference, iterations));
+        results.push_back(BenchSlices(world, t, iterations));
+    }
+    results.push_back(BenchMerge(world, 1000, std::max(1, iterations / 20)));
+    if (scaling) {
+        for (const auto& r : BenchScaling(format, 6)) results.push_back(r);
+    }
+
+    std::vector<StartupResult> startup;
+    startup.push_back(BenchStartup(format, false, 8));
+    startup.push_back(BenchStartup(format, true, 8));
+
+    std::vector<FlyResult> fly;
+    fly.push_back(BenchFlyThrough(format, 6, 64, true));
+    fly.push_back(BenchFlyThrough(format, 6, 64, false));
+    LodResult lod = BenchLod(format, 6, 8);
+    ClipmapResult clip = BenchClipmap(400, 12.0f);
+    if (verify && !clip.intact) return 1;
+    std::vector<RegionResult> regions = BenchRegions(format, 8);
+    if (verify) {
+        for (const auto& g : regions) {
+            if (!g.sameSurface) return 1;
+        }
+    }
+
+    std::vector<UploadResult> uploads;
+    std::vector<PacingResult> pacing;
+    {
+        std::vector<WorkResult> meshes = BurstMeshes(format, 5);
+        uploads.push_back(BenchUpload(meshes, format, SIZE_MAX));
+        uploads.push_back(BenchUpload(meshes, format, 2 << 20));
+        uploads.push_back(BenchUpload(meshes, format, 512 << 10));
+        pacing.push_back(BenchPacing(meshes, format, false));
+        pacing.push_back(BenchPacing(meshes, format, true));
+    }
+    if (verify) {
+        for (const auto& u : uploads) {
+            if (!u.intact) return 1;
+        }
+    }
+
+    if (json) PrintJson(results, startup, fly, lod, clip, regions, uploads, pacing);
+    else PrintText(results, startup, fly, lod, clip, regions, uploads, pacing);
+    return 0;
+}
@@ -2,18 +2,18 @@
 #include <GLFW/glfw3.h>
 #include <glm/ext/vector_float3.hpp>
 #include <glm/trigonometric.hpp>
+#include <cstdio>
 #include <iostream>
+#include <string>
 
 Application::Application() : deltaTime(0.0f) {
-    vertices.reserve(10000000);  
-    indices.reserve(15000000);
 }
 
 Application::~Application() {
-    _ebo.Delete();
-    _vbo.Delete();
-    _vao.Delete();
+    chunkMeshes.Delete();
+    clipmapRenderer.Delete();
     shader.Delete();
+    clipmapShader.Delete();
     if (window) {
         glfwDestroyWindow(window);
         glfwTerminate();
@@ -64,6 +64,11 @@ bool Application::SetShaders() {
         std::cerr << "Shader compilation failed\n";
         return false;
     }
+    clipmapShader.Refresh("shaders/clipmap.vert", "shaders/clipmap.frag");
+    if (!clipmapShader.ID) {
+        std::cerr << "Clipmap shader compilation failed\n";
+        return false;
+    }
     shader.Activate();
     return true;
 }
@@ -78,30 +83,82 @@ bool Application::SetCamera() {
 
 
 void Application::GenerateWorld() {
-    world.fetchMergedMesh(vertices, indices);
+    world.scheduleChunks(camera.CameraPos, camera.front);
+    world.fetchMeshUpdates(fetchedMeshes, pendingEvictions);
+    world.fetchLodUpdates(fetchedMeshes, pendingLodEvictions);
 }
 
-bool Application::SetBuffers() {
-    if (vertices.empty()) {
-        std::cerr << "No vertices for buffers\n";
-        return false;
+// Uploads queued meshes until the registry's per-frame budget is spent;
+// the rest wait for later frames.
+void Application::UploadChunkMeshes() {
+    for (const auto& coord : pendingEvictions) {
+        chunkMeshes.Evict(coord);
+        pendingMeshes.erase(glm::ivec4(coord, 0));
     }
+    pendingEvictions.clear();
+    for (const auto& key : pendingLodEvictions) {
+        chunkMeshes.Evict(glm::ivec3(key), key.w);
+        pendingMeshes.erase(key);
+    }
+    pendingLodEvictions.clear();
+    for (auto& mesh : fetchedMeshes) {
+        glm::ivec4 key(mesh.coord, mesh.lod);
+        if (pendingMeshes.insert_or_assign(key, std::move(mesh)).second) {
+            uploadOrder.push_back(key);
+        }
+    }
+    fetchedMeshes.clear();
+
+    chunkMeshes.BeginFrame();
+    while (!uploadOrder.empty()) {
+        auto it = pendingMeshes.find(uploadOrder.front());
+        if (it != pendingMeshes.end()) {
+            MeshUpload status = chunkMeshes.Upload(it->second);
+            if (status == MeshUpload::Deferred) break;
+            if (status == MeshUpload::OutOfSpace) {
+                // Stays queued behind the rest; evictions may free room.
+                uploadOrder.push_back(uploadOrder.front());
+                uploadOrder.pop_front();
+                break;
+            }
+            if (it->first.w == 0) world.markUploaded(glm::ivec3(it->first));
+            pendingMeshes.erase(it);
+        }
+        uploadOrder.pop_front();
+    }
+    chunkMeshes.EndFrame();
+}
 
+// Scrolls the far terrain with the camera and uploads the heights that came
+// into view.
+void Application::UpdateClipmap() {
+    clipmap.Update(glm::vec2(camera.CameraPos.x, camera.CameraPos.z));
+    clipmap.TakeUpdates(clipmapUpdates);
+    clipmapRenderer.Upload(clipmap, clipmapShader, clipmapUpdates);
+    clipmapUpdates.clear();
+}
 
-    if (_vao.ID != 0) _vao.Delete();
-    _vao.Refresh();
-    _vao.Bind();
-
-    if (_vbo.ID != 0) _vbo.Delete();
-    if (_ebo.ID != 0) _ebo.Delete();
-    _vbo.Refresh(vertices.data(), vertices.size() * sizeof(Vertex), GL_DYNAMIC_DRAW);
-    _ebo.Refresh(indices.data(), indices.size() * sizeof(GLuint), GL_DYNAMIC_DRAW);
-
-    _vao.LinkIntVbo(_vbo, 0, 3, 6, (void*)0);                       
-    _vao.LinkIntVbo(_vbo, 1, 3, 6, (void*)(3 * sizeof(int)));       
+// Chunk pipeline counters in the title bar, refreshed once a second.
+void Application::UpdateWindowTitle() {
+    ChunkStateTable::Counts counts = world.getChunkStateCounts();
+    std::string title = "Voxel |";
+    for (int i = 0; i < ChunkStateTable::StateCount; ++i) {
+        title += " ";
+        title += ChunkStateName(static_cast<ChunkState>(i));
+        title += " " + std::to_string(counts[i]);
+    }
+    title += " | visible " + std::to_string(chunkMeshes.VisibleCount());
+    title += " | upload queue " + std::to_string(pendingMeshes.size());
+    title += " | far columns queued " + std::to_string(world.pendingLodColumnCount());
+    FrameStats frames = frameBudget.Stats();
+    char timing[64];
+    std::snprintf(timing, sizeof(timing), " | frame p50 %.1f ms p99 %.1f ms", frames.p50Ms, frames.p99Ms);
+    title += timing;
+    glfwSetWindowTitle(window, title.c_str());
+}
 
-    _vbo.Unbind();
-    _vao.Unbind();
+bool Application::SetBuffers() {
+    UploadChunkMeshes();
 
 
     if (_skyVao.ID != 0) _skyVao.Delete();
@@ -135,12 +192,16 @@ void Application::Run() {
     InputHandler ih(window, &camera);
     float lastTime = 0.0f;
     float currentTime = 0.0f;
+    float lastTitleTime = 0.0f;
     glm::ivec3 lastCamChunk = glm::ivec3(999);
-    bool meshNeedsUpdate = true;
 
+    world.setLodLevels(lodLevels, renderDistance);
+    // Only chunks the surface passes through; the rest of the cube is solid
+    // ground or sky and has no faces. The LOD rings cut a square hole, so
+    // with them on the footprint stays square and only the clamp trims it.
+    RegionShape regionShape = lodLevels > 0 ? RegionShape::Cube : RegionShape::Cylinder;
+    world.setRenderRegion(regionShape, renderDistance, true);
     world.ChunkManager(camera.CameraPos, renderDistance);
-    GenerateWorld();
-    SetBuffers();
 
     auto skyBoxLoc = glGetUniformLocation(shader.ID, "skybox");
     auto isSkyBoxLoc = glGetUniformLocation(shader.ID, "isSkyBox");
@@ -148,13 +209,19 @@ void Application::Run() {
     auto LightViewLoc = glGetUniformLocation(shader.ID , "aLightView");
     auto LightProjection = glGetUniformLocation(shader.ID , "aLightProjection");
     auto LightPassLoc = glGetUniformLocation(shader.ID , "isLightPass");
+    auto cameraChunkLoc = glGetUniformLocation(shader.ID, "uCameraChunk");
+    auto quadsLoc = glGetUniformLocation(shader.ID, "uQuads");
+    auto pullQuadsLoc = glGetUniformLocation(shader.ID, "uPullQuads");
 
     globalLight.UpdatePosition(0);
     glm::vec3 lightPosition;
+    lastTime = static_cast<float>(glfwGetTime());
     while (!glfwWindowShouldClose(window)) {
         currentTime = static_cast<float>(glfwGetTime());
         deltaTime = currentTime - lastTime;
         lastTime = currentTime;
+        frameBudget.EndFrame(deltaTime, streamingBacklog);
+        chunkMeshes.SetUploadBudget(frameBudget.UploadBytes());
         globalLight.UpdatePosition(lastTime);
         lightPosition = globalLight.GetPosition();
         glfwPollEvents();
@@ -164,15 +231,19 @@ void Application::Run() {
 
         glm::ivec3 currCamChunk = glm::floor(camera.CameraPos / static_cast<float>(CHUNK_SIZE));
         if (currCamChunk != lastCamChunk) {
-            world.ChunkManager(camera.CameraPos, renderDistance);
-            meshNeedsUpdate = true;
+            world.ChunkManager(camera.CameraPos, renderDistance, 0);
             lastCamChunk = currCamChunk;
         }
+        size_t unscanned = world.scanChunks(frameBudget.ScanCoords());
+
+        GenerateWorld();
+        UploadChunkMeshes();
+        UpdateClipmap();
+        streamingBacklog = unscanned > 0 || !pendingMeshes.empty();
 
-        if (meshNeedsUpdate) {
-            GenerateWorld();
-            SetBuffers();
-            meshNeedsUpdate = false;
+        if (currentTime - lastTitleTime > 1.0f) {
+            UpdateWindowTitle();
+            lastTitleTime = currentTime;
         }
 
 
@@ -185,7 +256,10 @@ void Application::Run() {
         shader.setViewMatrix(glm::value_ptr(camera.getProjection()), glm::value_ptr(camera.getView()));
 
 
+        // The sky sits at a fixed distance, so it must not hide anything
+        // drawn after it.
         glDepthFunc(GL_LEQUAL);
+        glDepthMask(GL_FALSE);
         glUniform1i(skyBoxLoc, 0);
         glActiveTexture(GL_TEXTURE0);
         glUniform1i(isSkyBoxLoc, 1);
@@ -195,14 +269,24 @@ void Application::Run() {
         glDrawArrays(GL_TRIANGLES, 0, 36);
         _skyVao.Unbind();
         glUniform1i(isSkyBoxLoc, 0);  
+        glDepthMask(GL_TRUE);
+
+        // Far terrain gets its own depth range. Where a chunk is resident it
+        // is a finer version of the same surface, so the chunks are drawn
+        // over the clipmap instead of depth testing against it.
+        glUseProgram(clipmapShader.ID);
+        glm::mat4 farProjection = camera.getFarTerrainProjection();
+        clipmapShader.setViewMatrix(glm::value_ptr(farProjection), glm::value_ptr(camera.getView()));
+        clipmapRenderer.Draw(clipmap, lightPosition);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        glUseProgram(shader.ID);
 
 
         glDepthFunc(GL_LEQUAL);
-        _vao.Bind();
-        if (!indices.empty()) {
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-        }
-        _vao.Unbind();
+        glUniform3i(cameraChunkLoc, currCamChunk.x, currCamChunk.y, currCamChunk.z);
+        glUniform1i(quadsLoc, 1);
+        glUniform1i(pullQuadsLoc, meshFormat == MeshFormat::PulledQuads ? 1 : 0);
+        chunkMeshes.Draw(camera.getFrustum());
 
         glfwSwapBuffers(window);
     }
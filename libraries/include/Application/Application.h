@@ -5,6 +5,7 @@
 #define GLFW_INCLUDE_NONE
 
 #include <cstdlib>
+#include <deque>
 #include <iostream>
 #include <vector>
 #include <glm/glm.hpp>
@@ -21,24 +22,48 @@
 #include "../InputHandler/InputHandler.h"
 #include "../Texture/Texture.h"
 #include "../Light/Light.h"
+#include "../ChunkMeshRegistry/ChunkMeshRegistry.h"
+#include "../FrameBudget/FrameBudget.h"
+#include "../Clipmap/Clipmap.h"
+#include "../ClipmapRenderer/ClipmapRenderer.h"
 
 
 class Application {
 private:
     GLFWwindow* window = nullptr;
-    std::vector<Vertex> vertices;
-    std::vector<GLuint> indices;  
+    std::vector<WorkResult> fetchedMeshes;
+    std::vector<glm::ivec3> pendingEvictions;
+    std::vector<glm::ivec4> pendingLodEvictions;
+    // Meshes waiting for upload budget, newest per (coord, lod), in arrival
+    // order. uploadOrder may hold keys already uploaded or evicted; those
+    // are skipped.
+    std::unordered_map<glm::ivec4, WorkResult> pendingMeshes;
+    std::deque<glm::ivec4> uploadOrder;
     Texture skyCubeMap;
     Camera camera;
     Shader shader;
-    World world;
-    VAO _vao;
-    VBO _vbo;
-    EBO _ebo;
+    MeshFormat meshFormat = MeshFormat::PulledQuads;
+    World world{meshFormat};
+    ChunkMeshRegistry chunkMeshes{meshFormat};
+    // Sizes each frame's mesh uploads and chunk scan from measured frame
+    // times.
+    FrameBudget frameBudget;
+    bool streamingBacklog = false;
     VBO _skyVbo;
     VAO _skyVao;
     float deltaTime;
-    int renderDistance = 15;
+    int renderDistance = 15;  // at most 30, see PackVertex
+    // Coarser rings past renderDistance, each renderDistance of its own
+    // chunks wide, so the last one reaches 2^lodLevels times further.
+    int lodLevels = 3;
+    // Heightfield terrain out to the horizon, drawn before the chunks and
+    // overdrawn by them wherever they are resident.
+    Shader clipmapShader;
+    Clipmap clipmap{[this](glm::ivec2 origin, int stride, glm::ivec2 size, int* heights) {
+        world.sampleHeights(origin, stride, size, heights);
+    }};
+    ClipmapRenderer clipmapRenderer;
+    std::vector<ClipmapUpdate> clipmapUpdates;
     float Gravity = 1;
     Light globalLight;
     static constexpr GLfloat skyVerts[] = {
@@ -93,9 +118,12 @@ public:
     Application() ;
     ~Application() ;
     void GenerateWorld();
+    void UpdateWindowTitle();
     bool Initialize() ;
     bool SetWindow() ;
     bool SetBuffers() ;
+    void UploadChunkMeshes() ;
+    void UpdateClipmap() ;
     void SetTexture() ;
     void setCubeMap();
     bool SetShaders() ;
@@ -0,0 +1,119 @@
+#include "./BufferArena.h"
+#include <algorithm>
+
+BufferArena::BufferArena(size_t capacity) {
+    Reset(capacity);
+}
+
+void BufferArena::Reset(size_t newCapacity) {
+    capacity = newCapacity;
+    used = 0;
+    freeByOffset.clear();
+    freeBySize.clear();
+    liveByOffset.clear();
+    if (capacity > 0) InsertFree(0, capacity);
+}
+
+void BufferArena::InsertFree(size_t offset, size_t size) {
+    freeByOffset[offset] = size;
+    freeBySize.emplace(size, offset);
+}
+
+void BufferArena::EraseFree(std::map<size_t, size_t>::iterator it) {
+    auto range = freeBySize.equal_range(it->second);
+    for (auto s = range.first; s != range.second; ++s) {
+        if (s->second == it->first) {
+            freeBySize.erase(s);
+            break;
+        }
+    }
+    freeByOffset.erase(it);
+}
+
+bool BufferArena::Allocate(size_t size, ArenaRange& out) {
+    if (size == 0) return false;
+    auto best = freeBySize.lower_bound(size);
+    if (best == freeBySize.end()) return false;
+    size_t blockSize = best->first;
+    size_t offset = best->second;
+    EraseFree(freeByOffset.find(offset));
+    if (blockSize > size) InsertFree(offset + size, blockSize - size);
+    liveByOffset[offset] = size;
+    used += size;
+    out.offset = offset;
+    out.size = size;
+    return true;
+}
+
+void BufferArena::Free(const ArenaRange& range) {
+    auto live = liveByOffset.find(range.offset);
+    if (live == liveByOffset.end()) return;
+    size_t offset = live->first;
+    size_t size = live->second;
+    liveByOffset.erase(live);
+    used -= size;
+
+    auto next = freeByOffset.lower_bound(offset);
+    if (next != freeByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        EraseFree(next);
+    }
+    auto prev = freeByOffset.lower_bound(offset);
+    if (prev != freeByOffset.begin()) {
+        --prev;
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            EraseFree(prev);
+        }
+    }
+    InsertFree(offset, size);
+}
+
+void BufferArena::Grow(size_t newCapacity) {
+    if (newCapacity <= capacity) return;
+    size_t offset = capacity;
+    size_t size = newCapacity - capacity;
+    capacity = newCapacity;
+    auto last = freeByOffset.empty() ? freeByOffset.end() : std::prev(freeByOffset.end());
+    if (last != freeByOffset.end() && last->first + last->second == offset) {
+        offset = last->first;
+        size += last->second;
+        EraseFree(last);
+    }
+    InsertFree(offset, size);
+}
+
+std::vector<ArenaMove> BufferArena::Compact() {
+    std::vector<ArenaMove> moves;
+    std::map<size_t, size_t> packed;
+    size_t cursor = 0;
+    for (const auto& p : liveByOffset) {
+        if (p.first != cursor) moves.push_back({p.first, cursor, p.second});
+        packed[cursor] = p.second;
+        cursor += p.second;
+    }
+    liveByOffset.swap(packed);
+    freeByOffset.clear();
+    freeBySize.clear();
+    if (cursor < capacity) InsertFree(cursor, capacity - cursor);
+    return moves;
+}
+
+ArenaStats BufferArena::Stats() const {
+    ArenaStats stats;
+    stats.capacity = capacity;
+    stats.used = used;
+    stats.free = capacity - used;
+    stats.freeBlocks = freeByOffset.size();
+    stats.allocations = liveByOffset.size();
+    stats.largestFree = freeBySize.empty() ? 0 : std::prev(freeBySize.end())->first;
+    if (stats.free > 0) {
+        stats.fragmentation = 1.0f - static_cast<float>(stats.largestFree) / static_cast<float>(stats.free);
+    }
+    return stats;
+}
+
+size_t BufferArena::Capacity() const {
+    return capacity;
+}
@@ -0,0 +1,55 @@
+#ifndef BUFFER_ARENA_H
+#define BUFFER_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Offsets and sizes are in elements of whatever the owning buffer stores.
+struct ArenaRange {
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+struct ArenaMove {
+    size_t from;
+    size_t to;
+    size_t size;
+};
+
+struct ArenaStats {
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t free = 0;
+    size_t largestFree = 0;
+    size_t freeBlocks = 0;
+    size_t allocations = 0;
+    // 0 when all free space is one block, approaching 1 as it splinters.
+    float fragmentation = 0.0f;
+};
+
+// CPU-side best-fit free-list that hands out ranges of one GPU buffer
+// allocated up front. Adjacent free blocks are coalesced on Free.
+class BufferArena {
+private:
+    size_t capacity = 0;
+    size_t used = 0;
+    std::map<size_t, size_t> freeByOffset;
+    std::multimap<size_t, size_t> freeBySize;
+    std::map<size_t, size_t> liveByOffset;
+    void InsertFree(size_t offset, size_t size);
+    void EraseFree(std::map<size_t, size_t>::iterator it);
+public:
+    explicit BufferArena(size_t capacity = 0);
+    void Reset(size_t newCapacity);
+    bool Allocate(size_t size, ArenaRange& out);
+    void Free(const ArenaRange& range);
+    void Grow(size_t newCapacity);
+    // Packs every live range towards offset 0 and returns the moves the
+    // owner has to replay on the GPU buffer, in ascending offset order.
+    std::vector<ArenaMove> Compact();
+    ArenaStats Stats() const;
+    size_t Capacity() const;
+};
+
+#endif
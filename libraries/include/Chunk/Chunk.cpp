@@ -0,0 +1,143 @@
+#include "Chunk.h"
+#include <algorithm>
+
+static uint8_t BitsFor(size_t paletteSize) {
+    if (paletteSize <= 1) return 0;
+    if (paletteSize <= 2) return 1;
+    if (paletteSize <= 4) return 2;
+    if (paletteSize <= 16) return 4;
+    return 8;
+}
+
+static size_t WordsFor(uint8_t bits) {
+    return (static_cast<size_t>(Chunk::VOLUME) * bits + 63) / 64;
+}
+
+void Chunk::repack(uint8_t newBits) {
+    std::vector<uint64_t> packed(WordsFor(newBits), 0);
+    if (newBits > 0) {
+        for (int i = 0; i < VOLUME; ++i) {
+            uint64_t p = (bits == 0) ? 0 : static_cast<uint64_t>(paletteIndex(i));
+            size_t bit = static_cast<size_t>(i) * newBits;
+            packed[bit >> 6] |= p << (bit & 63);
+        }
+    }
+    indices.swap(packed);
+    bits = newBits;
+}
+
+void Chunk::set(int x, int y, int z, BlockType block) {
+    auto it = std::find(palette.begin(), palette.end(), block);
+    size_t p = static_cast<size_t>(it - palette.begin());
+    if (it == palette.end()) {
+        palette.push_back(block);
+        uint8_t needed = BitsFor(palette.size());
+        if (needed != bits) repack(needed);
+    }
+    if (bits == 0) return;
+    size_t bit = static_cast<size_t>(Index(x, y, z)) * bits;
+    uint64_t mask = ((1ull << bits) - 1) << (bit & 63);
+    uint64_t& word = indices[bit >> 6];
+    word = (word & ~mask) | (static_cast<uint64_t>(p) << (bit & 63));
+}
+
+void Chunk::decode(std::array<BlockType, VOLUME>& dense) const {
+    if (bits == 0) {
+        dense.fill(palette[0]);
+        return;
+    }
+    const uint64_t mask = (1ull << bits) - 1;
+    const int perWord = 64 / bits;
+    int i = 0;
+    for (uint64_t word : indices) {
+        for (int k = 0; k < perWord && i < VOLUME; ++k, ++i) {
+            dense[i] = palette[word & mask];
+            word >>= bits;
+        }
+    }
+}
+
+void Chunk::assign(const std::array<BlockType, VOLUME>& dense) {
+    // Map block value -> palette slot; 0xFF marks an unused value.
+    uint8_t slot[256];
+    std::fill_n(slot, 256, static_cast<uint8_t>(0xFF));
+    palette.clear();
+    for (BlockType b : dense) {
+        uint8_t v = static_cast<uint8_t>(b);
+        if (slot[v] == 0xFF) {
+            slot[v] = static_cast<uint8_t>(palette.size());
+            palette.push_back(b);
+        }
+    }
+    bits = BitsFor(palette.size());
+    indices = std::vector<uint64_t>(WordsFor(bits), 0);
+    if (bits == 0) return;
+    for (int i = 0; i < VOLUME; ++i) {
+        size_t bit = static_cast<size_t>(i) * bits;
+        indices[bit >> 6] |= static_cast<uint64_t>(slot[static_cast<uint8_t>(dense[i])]) << (bit & 63);
+    }
+}
+
+void Chunk::fill(BlockType block) {
+    palette.assign(1, block);
+    indices.clear();
+    indices.shrink_to_fit();
+    bits = 0;
+}
+
+void Chunk::compact() {
+    if (bits == 0) return;
+    std::array<BlockType, VOLUME> dense;
+    decode(dense);
+    assign(dense);
+    palette.shrink_to_fit();
+}
+
+bool Chunk::layerHasSolid(int axis, int layer) const {
+    if (bits == 0) return palette[0] == BlockType::SOLID;
+    for (int a = 0; a < CS; ++a) {
+        for (int b = 0; b < CS; ++b) {
+            int x = (axis == 0) ? layer : a;
+            int y = (axis == 1) ? layer : (axis == 0 ? a : b);
+            int z = (axis == 2) ? layer : b;
+            if (get(x, y, z) == BlockType::SOLID) return true;
+        }
+    }
+    return false;
+}
+
+size_t Chunk::memoryUsage() const {
+    return sizeof(Chunk) + palette.capacity() * sizeof(BlockType) + indices.capacity() * sizeof(uint64_t);
+}
+
+void PaddedChunk::gather(const Chunk& center, const std::array<const Chunk*, 6>& neighbors) {
+    constexpr int CS = CHUNK_SIZE;
+    blocks.fill(BlockType::AIR);
+    std::array<BlockType, Chunk::VOLUME> dense;
+    center.decode(dense);
+    for (int z = 0; z < CS; ++z) {
+        for (int y = 0; y < CS; ++y) {
+            std::copy_n(&dense[y * CS + z * CS * CS], CS, &blocks[Index(0, y, z)]);
+        }
+    }
+    for (int d = 0; d < 6; ++d) {
+        const Chunk* neighbor = neighbors[d];
+        if (!neighbor) continue;
+        int axis = d / 2;
+        bool isPos = (d % 2 == 0);
+        int source = isPos ? 0 : CS - 1;
+        int target = isPos ? CS : -1;
+        for (int a = 0; a < CS; ++a) {
+            for (int b = 0; b < CS; ++b) {
+                int x = (axis == 0) ? source : a;
+                int y = (axis == 1) ? source : (axis == 0 ? a : b);
+                int z = (axis == 2) ? source : b;
+                BlockType block = neighbor->get(x, y, z);
+                if (axis == 0) x = target;
+                else if (axis == 1) y = target;
+                else z = target;
+                blocks[Index(x, y, z)] = block;
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define CHUNK_SIZE 16
+// Full resolution plus three coarser levels at 2x, 4x and 8x cell size;
+// PackVertex stores the level in two bits.
+#define LOD_LEVELS 4
+
+enum class BlockType : uint8_t {
+    NONE,
+    SOLID,
+    AIR
+};
+
+// Blocks are stored as indices into a per-chunk palette, packed into 64-bit
+// words at 0, 1, 2, 4 or 8 bits each. Power-of-two widths keep every index
+// inside one word. A chunk holding a single block type has zero-width
+// indices and no index storage at all.
+class Chunk {
+public:
+    static constexpr int CS = CHUNK_SIZE;
+    static constexpr int CS_SQR = CS * CS;
+    static constexpr int VOLUME = CS * CS * CS;
+private:
+    std::vector<BlockType> palette{BlockType::AIR};
+    std::vector<uint64_t> indices;
+    uint8_t bits = 0;
+
+    static int Index(int x, int y, int z) {
+        return x + y * CS + z * CS_SQR;
+    }
+    int paletteIndex(int i) const {
+        size_t bit = static_cast<size_t>(i) * bits;
+        return static_cast<int>((indices[bit >> 6] >> (bit & 63)) & ((1ull << bits) - 1));
+    }
+    void repack(uint8_t newBits);
+public:
+    BlockType get(int x, int y, int z) const {
+        if (bits == 0) return palette[0];
+        return palette[paletteIndex(Index(x, y, z))];
+    }
+    void set(int x, int y, int z, BlockType block);
+    // Expands the whole chunk to x-fastest dense data; cheaper than VOLUME
+    // get() calls when a mesher visits every block.
+    void decode(std::array<BlockType, VOLUME>& dense) const;
+    // Replaces the whole chunk from x-fastest dense data, building the
+    // smallest palette that fits.
+    void assign(const std::array<BlockType, VOLUME>& dense);
+    void fill(BlockType block);
+    void initToAir() {
+        fill(BlockType::AIR);
+    }
+    // Drops palette entries no longer referenced after set() calls.
+    void compact();
+
+    // Whether the CS x CS layer at the given position along axis (0 = x,
+    // 1 = y, 2 = z) contains any solid block.
+    bool layerHasSolid(int axis, int layer) const;
+
+    bool isUniform() const {
+        return bits == 0;
+    }
+    // Only meaningful when isUniform().
+    BlockType uniformBlock() const {
+        return palette[0];
+    }
+    size_t paletteSize() const {
+        return palette.size();
+    }
+    // Heap plus inline bytes held by this chunk.
+    size_t memoryUsage() const;
+};
+
+// A chunk's blocks plus a one-block border taken from its six face
+// neighbours, as a flat x-fastest (CS + 2)^3 array. Meshers read it without
+// bounds checks or neighbour lookups. Border cells of missing neighbours,
+// and the unused edge and corner cells, hold AIR.
+struct PaddedChunk {
+    static constexpr int PS = CHUNK_SIZE + 2;
+    static constexpr int PS_SQR = PS * PS;
+    static constexpr int VOLUME = PS * PS * PS;
+    std::array<BlockType, VOLUME> blocks;
+
+    // Local chunk coordinates, each in [-1, CHUNK_SIZE].
+    static int Index(int x, int y, int z) {
+        return (x + 1) + (y + 1) * PS + (z + 1) * PS_SQR;
+    }
+    BlockType get(int x, int y, int z) const {
+        return blocks[Index(x, y, z)];
+    }
+    // Neighbours are ordered +X, -X, +Y, -Y, +Z, -Z; null entries are
+    // treated as air.
+    void gather(const Chunk& center, const std::array<const Chunk*, 6>& neighbors);
+};
+
+#endif
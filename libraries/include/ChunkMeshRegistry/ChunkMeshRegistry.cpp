@@ -0,0 +1,388 @@
+#include "./ChunkMeshRegistry.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Copies the given element ranges of oldID into a freshly allocated buffer
+// of newSize bytes and returns it. The old buffer is deleted.
+static GLuint ReallocateBuffer(GLuint oldID, GLsizeiptr newSize, const std::vector<ArenaMove>& copies, size_t elementSize) {
+    GLuint newID = 0;
+    glGenBuffers(1, &newID);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newID);
+    glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, oldID);
+    for (const auto& c : copies) {
+        if (c.size == 0) continue;
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            static_cast<GLintptr>(c.from * elementSize),
+                            static_cast<GLintptr>(c.to * elementSize),
+                            static_cast<GLsizeiptr>(c.size * elementSize));
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &oldID);
+    return newID;
+}
+
+// GL 3.3 has no persistent mapping, so each staging write maps just its
+// own range, unsynchronized. That is safe because StagingUploader only
+// hands out ranges whose earlier copies sit behind a signaled fence.
+class GLUploadBackend : public UploadBackend {
+private:
+    GLuint staging = 0;
+    // The registry reallocates these on growth and compaction.
+    const GLuint& vertexBuffer;
+    const GLuint& indexBuffer;
+    GLuint Target(UploadTarget target) const {
+        return target == UploadTarget::Vertices ? vertexBuffer : indexBuffer;
+    }
+public:
+    GLUploadBackend(size_t capacity, const GLuint& vertexBuffer, const GLuint& indexBuffer)
+        : vertexBuffer(vertexBuffer), indexBuffer(indexBuffer) {
+        glGenBuffers(1, &staging);
+        glBindBuffer(GL_COPY_READ_BUFFER, staging);
+        glBufferData(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    ~GLUploadBackend() override {
+        glDeleteBuffers(1, &staging);
+    }
+    void WriteStaging(size_t offset, const void* data, size_t bytes) override {
+        glBindBuffer(GL_COPY_READ_BUFFER, staging);
+        void* mapped = glMapBufferRange(GL_COPY_READ_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped) {
+            std::memcpy(mapped, data, bytes);
+            glUnmapBuffer(GL_COPY_READ_BUFFER);
+        } else {
+            glBufferSubData(GL_COPY_READ_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    void CopyStaging(UploadTarget target, size_t stagingOffset, size_t destOffset, size_t bytes) override {
+        glBindBuffer(GL_COPY_READ_BUFFER, staging);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, Target(target));
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(stagingOffset),
+                            static_cast<GLintptr>(destOffset), static_cast<GLsizeiptr>(bytes));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    void WriteDirect(UploadTarget target, size_t destOffset, const void* data, size_t bytes) override {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, Target(target));
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(destOffset), static_cast<GLsizeiptr>(bytes), data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    uint64_t InsertFence() override {
+        GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(sync));
+    }
+    bool IsSignaled(uint64_t fence) override {
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(reinterpret_cast<GLsync>(static_cast<uintptr_t>(fence)), GL_SYNC_STATUS, 1, nullptr, &status);
+        return status == GL_SIGNALED;
+    }
+    void DeleteFence(uint64_t fence) override {
+        glDeleteSync(reinterpret_cast<GLsync>(static_cast<uintptr_t>(fence)));
+    }
+};
+
+ChunkMeshRegistry::ChunkMeshRegistry(MeshFormat format) : format(format) {
+}
+
+void ChunkMeshRegistry::Initialize() {
+    vao.Refresh();
+    vao.Bind();
+    if (format == MeshFormat::PulledQuads) {
+        GLint maxTexels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+        maxQuads = static_cast<size_t>(maxTexels);
+        size_t capacity = std::min(initialQuadCapacity, maxQuads);
+        vertexArena.Reset(capacity);
+        vbo.Allocate(capacity * sizeof(PackedQuad), GL_DYNAMIC_DRAW);
+        glGenTextures(1, &quadTexture);
+    } else {
+        vertexArena.Reset(initialVertexCapacity);
+        indexArena.Reset(initialIndexCapacity);
+        vbo.Allocate(initialVertexCapacity * sizeof(PackedVertex), GL_DYNAMIC_DRAW);
+        ebo.Allocate(initialIndexCapacity * sizeof(GLuint), GL_DYNAMIC_DRAW);
+    }
+    LinkArrays();
+    vao.Unbind();
+    uploadBackend.reset(new GLUploadBackend(stagingCapacity, vbo.ID, ebo.ID));
+    uploader.reset(new StagingUploader(*uploadBackend, stagingCapacity, uploadBudget));
+}
+
+void ChunkMeshRegistry::LinkArrays() {
+    if (format == MeshFormat::PulledQuads) {
+        glBindTexture(GL_TEXTURE_BUFFER, quadTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, vbo.ID);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        return;
+    }
+    vao.LinkUIntVbo(vbo, 0, 2, 2, (void*)0);
+    ebo.Bind();
+}
+
+bool ChunkMeshRegistry::Reserve(BufferArena& arena, size_t size, ArenaRange& out) {
+    if (arena.Allocate(size, out)) return true;
+    bool isIndexArena = (&arena == &indexArena);
+    size_t elementSize = isIndexArena ? sizeof(GLuint) : sizeof(PackedVertex);
+    ArenaStats stats = arena.Stats();
+    if (stats.free >= size && stats.fragmentation > compactThreshold) {
+        Relocate(arena, arena.Compact(), elementSize, isIndexArena);
+        if (arena.Allocate(size, out)) return true;
+    }
+    size_t newCapacity = std::max(arena.Capacity() * 2, arena.Capacity() + size);
+    if (format == MeshFormat::PulledQuads) {
+        newCapacity = std::min(newCapacity, maxQuads);
+        if (newCapacity <= arena.Capacity()) return false;
+    }
+    Resize(arena, newCapacity, elementSize, isIndexArena);
+    return arena.Allocate(size, out);
+}
+
+void ChunkMeshRegistry::Relocate(BufferArena& arena, const std::vector<ArenaMove>& moves, size_t elementSize, bool isIndexArena) {
+    if (moves.empty()) return;
+    std::unordered_map<size_t, size_t> moved;
+    moved.reserve(moves.size());
+    for (const auto& m : moves) moved[m.from] = m.to;
+
+    std::vector<ArenaMove> copies;
+    copies.reserve(meshes.size());
+    for (auto& p : meshes) {
+        ArenaRange& range = isIndexArena ? p.second.indices : p.second.vertices;
+        auto it = moved.find(range.offset);
+        size_t to = (it != moved.end()) ? it->second : range.offset;
+        copies.push_back({range.offset, to, range.size});
+        range.offset = to;
+    }
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(arena.Capacity() * elementSize);
+    if (isIndexArena) ebo.ID = ReallocateBuffer(ebo.ID, bytes, copies, elementSize);
+    else vbo.ID = ReallocateBuffer(vbo.ID, bytes, copies, elementSize);
+    vao.Bind();
+    LinkArrays();
+    vao.Unbind();
+}
+
+void ChunkMeshRegistry::Resize(BufferArena& arena, size_t newCapacity, size_t elementSize, bool isIndexArena) {
+    std::vector<ArenaMove> copies = {{0, 0, arena.Capacity()}};
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(newCapacity * elementSize);
+    if (isIndexArena) ebo.ID = ReallocateBuffer(ebo.ID, bytes, copies, elementSize);
+    else vbo.ID = ReallocateBuffer(vbo.ID, bytes, copies, elementSize);
+    arena.Grow(newCapacity);
+    vao.Bind();
+    LinkArrays();
+    vao.Unbind();
+}
+
+void ChunkMeshRegistry::BeginFrame() {
+    if (uploader) uploader->BeginFrame();
+}
+
+void ChunkMeshRegistry::EndFrame() {
+    if (uploader) uploader->EndFrame();
+}
+
+void ChunkMeshRegistry::SetUploadBudget(size_t bytesPerFrame) {
+    uploadBudget = bytesPerFrame;
+    if (uploader) uploader->SetFrameBudget(bytesPerFrame);
+}
+
+// Space for the new mesh is reserved before the old one is freed, so a
+// chunk whose mesh does not fit keeps drawing its previous one.
+MeshUpload ChunkMeshRegistry::Upload(const WorkResult& result) {
+    glm::ivec4 key(result.coord, result.lod);
+    if (format == MeshFormat::PulledQuads) {
+        if (result.quads.empty()) {
+            Evict(result.coord, result.lod);
+            return MeshUpload::Uploaded;
+        }
+        if (vao.ID == 0) Initialize();
+        size_t bytes = result.quads.size() * sizeof(PackedQuad);
+        if (!uploader->CanUpload(bytes)) return MeshUpload::Deferred;
+        ChunkMesh mesh;
+        if (!Reserve(vertexArena, result.quads.size(), mesh.vertices)) return OutOfSpace(result);
+        Evict(result.coord, result.lod);
+        uploader->Upload(UploadTarget::Vertices, mesh.vertices.offset * sizeof(PackedQuad), result.quads.data(), bytes);
+        meshes[key] = mesh;
+        residentDirty = true;
+        outOfSpaceLogged = false;
+        return MeshUpload::Uploaded;
+    }
+    if (result.indices.empty()) {
+        Evict(result.coord, result.lod);
+        return MeshUpload::Uploaded;
+    }
+    if (vao.ID == 0) Initialize();
+    size_t vertexBytes = result.vertices.size() * sizeof(PackedVertex);
+    size_t indexBytes = result.indices.size() * sizeof(GLuint);
+    if (!uploader->CanUpload(vertexBytes + indexBytes)) return MeshUpload::Deferred;
+
+    ChunkMesh mesh;
+    if (!Reserve(vertexArena, result.vertices.size(), mesh.vertices)) return OutOfSpace(result);
+    if (!Reserve(indexArena, result.indices.size(), mesh.indices)) {
+        vertexArena.Free(mesh.vertices);
+        return OutOfSpace(result);
+    }
+    Evict(result.coord, result.lod);
+    uploader->Upload(UploadTarget::Vertices, mesh.vertices.offset * sizeof(PackedVertex), result.vertices.data(), vertexBytes);
+    uploader->Upload(UploadTarget::Indices, mesh.indices.offset * sizeof(GLuint), result.indices.data(), indexBytes);
+    meshes[key] = mesh;
+    residentDirty = true;
+    outOfSpaceLogged = false;
+    return MeshUpload::Uploaded;
+}
+
+// Logged once per run of failures; the caller retries every frame.
+MeshUpload ChunkMeshRegistry::OutOfSpace(const WorkResult& result) {
+    if (!outOfSpaceLogged) {
+        std::cerr << "Chunk mesh arena full, deferring mesh for chunk " << result.coord.x << "," << result.coord.y << ","
+                  << result.coord.z << " (lod " << result.lod << ")\n";
+        outOfSpaceLogged = true;
+    }
+    return MeshUpload::OutOfSpace;
+}
+
+void ChunkMeshRegistry::Evict(glm::ivec3 coord, int lod) {
+    auto it = meshes.find(glm::ivec4(coord, lod));
+    if (it == meshes.end()) return;
+    vertexArena.Free(it->second.vertices);
+    indexArena.Free(it->second.indices);
+    meshes.erase(it);
+    residentDirty = true;
+}
+
+void ChunkMeshRegistry::Compact() {
+    if (vao.ID == 0) return;
+    Relocate(vertexArena, vertexArena.Compact(), sizeof(PackedVertex), false);
+    if (format == MeshFormat::IndexedVertices) {
+        Relocate(indexArena, indexArena.Compact(), sizeof(GLuint), true);
+    }
+}
+
+void ChunkMeshRegistry::RebuildResidentList() {
+    for (int level = 0; level < LOD_LEVELS; ++level) {
+        residentCoords[level].clear();
+        residentMeshes[level].clear();
+    }
+    for (const auto& p : meshes) {
+        int level = p.first.w;
+        residentCoords[level].push_back(glm::ivec3(p.first));
+        residentMeshes[level].push_back(&p.second);
+    }
+    for (int level = 0; level < LOD_LEVELS; ++level) {
+        cullers[level].SetChunks(residentCoords[level], static_cast<float>(CHUNK_SIZE << level));
+    }
+    residentDirty = false;
+}
+
+void ChunkMeshRegistry::PushDrawCommand(const ChunkMesh& mesh) {
+    if (format == MeshFormat::PulledQuads) {
+        DrawArraysCommand cmd;
+        cmd.count = static_cast<GLuint>(mesh.vertices.size * 6);
+        cmd.instanceCount = 1;
+        cmd.first = static_cast<GLuint>(mesh.vertices.offset * 6);
+        cmd.baseInstance = 0;
+        arrayCommands.push_back(cmd);
+        return;
+    }
+    DrawElementsCommand cmd;
+    cmd.count = static_cast<GLuint>(mesh.indices.size);
+    cmd.instanceCount = 1;
+    cmd.firstIndex = static_cast<GLuint>(mesh.indices.offset);
+    cmd.baseVertex = static_cast<GLint>(mesh.vertices.offset);
+    cmd.baseInstance = 0;
+    drawCommands.push_back(cmd);
+}
+
+void ChunkMeshRegistry::SubmitDrawCommands() {
+    if (format == MeshFormat::PulledQuads) {
+        if (arrayCommands.empty()) return;
+        drawCounts.clear();
+        drawFirsts.clear();
+        for (const auto& cmd : arrayCommands) {
+            drawCounts.push_back(static_cast<GLsizei>(cmd.count));
+            drawFirsts.push_back(static_cast<GLint>(cmd.first));
+        }
+        vao.Bind();
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_BUFFER, quadTexture);
+        glMultiDrawArrays(GL_TRIANGLES, drawFirsts.data(), drawCounts.data(), static_cast<GLsizei>(arrayCommands.size()));
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+        vao.Unbind();
+        return;
+    }
+    if (drawCommands.empty()) return;
+    drawCounts.clear();
+    drawOffsets.clear();
+    drawBaseVertices.clear();
+    for (const auto& cmd : drawCommands) {
+        drawCounts.push_back(static_cast<GLsizei>(cmd.count));
+        drawOffsets.push_back((const void*)(static_cast<size_t>(cmd.firstIndex) * sizeof(GLuint)));
+        drawBaseVertices.push_back(cmd.baseVertex);
+    }
+    vao.Bind();
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(),
+                                  static_cast<GLsizei>(drawCommands.size()), drawBaseVertices.data());
+    vao.Unbind();
+}
+
+void ChunkMeshRegistry::Draw(const Frustum& frustum) {
+    if (vao.ID == 0) return;
+    if (residentDirty) RebuildResidentList();
+    drawCommands.clear();
+    arrayCommands.clear();
+    visibleCount = 0;
+    for (int level = 0; level < LOD_LEVELS; ++level) {
+        if (residentMeshes[level].empty()) continue;
+        visibleChunks.clear();
+        cullers[level].Cull(frustum, visibleChunks);
+        for (uint32_t i : visibleChunks) {
+            PushDrawCommand(*residentMeshes[level][i]);
+        }
+        visibleCount += visibleChunks.size();
+    }
+    SubmitDrawCommands();
+}
+
+void ChunkMeshRegistry::Delete() {
+    uploader.reset();
+    uploadBackend.reset();
+    if (quadTexture != 0) glDeleteTextures(1, &quadTexture);
+    quadTexture = 0;
+    if (ebo.ID != 0) ebo.Delete();
+    if (vbo.ID != 0) vbo.Delete();
+    if (vao.ID != 0) vao.Delete();
+    ebo.ID = 0;
+    vbo.ID = 0;
+    vao.ID = 0;
+    vertexArena.Reset(0);
+    indexArena.Reset(0);
+    meshes.clear();
+    residentDirty = true;
+}
+
+size_t ChunkMeshRegistry::Size() const {
+    return meshes.size();
+}
+
+size_t ChunkMeshRegistry::VisibleCount() const {
+    return visibleCount;
+}
+
+MeshFormat ChunkMeshRegistry::Format() const {
+    return format;
+}
+
+ArenaStats ChunkMeshRegistry::VertexStats() const {
+    return vertexArena.Stats();
+}
+
+ArenaStats ChunkMeshRegistry::IndexStats() const {
+    return indexArena.Stats();
+}
+
+UploadStats ChunkMeshRegistry::UploadStatistics() const {
+    return uploader ? uploader->Stats() : UploadStats();
+}
@@ -0,0 +1,105 @@
+#ifndef CHUNK_MESH_REGISTRY_H
+#define CHUNK_MESH_REGISTRY_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+#include "../glad/glad.h"
+#include "../VAO/VAO.h"
+#include "../VBO/VBO.h"
+#include "../EBO/EBO.h"
+#include "../BufferArena/BufferArena.h"
+#include "../Frustum/Frustum.h"
+#include "../StagingUploader/StagingUploader.h"
+#include "../World/World.h"
+
+enum class MeshUpload {
+    Uploaded,
+    // This frame's upload budget is spent; retry next frame.
+    Deferred,
+    // The arenas cannot grow to hold the mesh. Nothing changed and the
+    // chunk keeps its previous mesh.
+    OutOfSpace
+};
+
+struct ChunkMesh {
+    // Packed vertices, or packed quads when pulling.
+    ArenaRange vertices;
+    ArenaRange indices;
+};
+
+// Keeps every finished chunk mesh resident on the GPU. All chunks share one
+// vertex arena and one index arena that are allocated once; each chunk owns
+// a sub-range of both, so a chunk crossing only uploads new meshes and frees
+// evicted ones. With MeshFormat::PulledQuads the vertex arena holds quads,
+// exposed to the shader as a texture buffer, and no index arena is used.
+// Mesh data reaches the arenas through a fenced staging ring, a frame's
+// worth of bytes at a time; Upload refuses a mesh once the frame's budget
+// is spent and the caller retries it next frame. Meshes are keyed by chunk
+// coordinate and LOD level, and each level is culled with its own chunk
+// size.
+class ChunkMeshRegistry {
+private:
+    static constexpr size_t initialVertexCapacity = 1 << 21;
+    static constexpr size_t initialIndexCapacity = initialVertexCapacity / 4 * 6;
+    static constexpr size_t initialQuadCapacity = initialVertexCapacity / 4;
+    MeshFormat format;
+    size_t maxQuads = 0;
+    static constexpr float compactThreshold = 0.5f;
+    static constexpr size_t stagingCapacity = 8 << 20;
+    size_t uploadBudget = 2 << 20;
+    std::unique_ptr<UploadBackend> uploadBackend;
+    std::unique_ptr<StagingUploader> uploader;
+    std::unordered_map<glm::ivec4, ChunkMesh> meshes;
+    std::array<std::vector<glm::ivec3>, LOD_LEVELS> residentCoords;
+    std::array<std::vector<const ChunkMesh*>, LOD_LEVELS> residentMeshes;
+    std::array<ChunkCuller, LOD_LEVELS> cullers;
+    std::vector<uint32_t> visibleChunks;
+    size_t visibleCount = 0;
+    bool residentDirty = true;
+    bool outOfSpaceLogged = false;
+    std::vector<DrawElementsCommand> drawCommands;
+    std::vector<GLsizei> drawCounts;
+    std::vector<const void*> drawOffsets;
+    std::vector<GLint> drawBaseVertices;
+    std::vector<DrawArraysCommand> arrayCommands;
+    std::vector<GLint> drawFirsts;
+    BufferArena vertexArena;
+    BufferArena indexArena;
+    VAO vao;
+    VBO vbo;
+    EBO ebo;
+    GLuint quadTexture = 0;
+    void Initialize();
+    void LinkArrays();
+    bool Reserve(BufferArena& arena, size_t size, ArenaRange& out);
+    MeshUpload OutOfSpace(const WorkResult& result);
+    void Relocate(BufferArena& arena, const std::vector<ArenaMove>& moves, size_t elementSize, bool isIndexArena);
+    void Resize(BufferArena& arena, size_t newCapacity, size_t elementSize, bool isIndexArena);
+    void RebuildResidentList();
+    void PushDrawCommand(const ChunkMesh& mesh);
+    void SubmitDrawCommands();
+public:
+    explicit ChunkMeshRegistry(MeshFormat format = MeshFormat::PulledQuads);
+    void BeginFrame();
+    // Anything but Uploaded leaves the chunk's previous mesh in place, and
+    // the caller should keep the mesh queued and try again later.
+    MeshUpload Upload(const WorkResult& result);
+    void EndFrame();
+    void SetUploadBudget(size_t bytesPerFrame);
+    void Evict(glm::ivec3 coord, int lod = 0);
+    void Compact();
+    void Draw(const Frustum& frustum);
+    void Delete();
+    size_t Size() const;
+    size_t VisibleCount() const;
+    MeshFormat Format() const;
+    ArenaStats VertexStats() const;
+    ArenaStats IndexStats() const;
+    UploadStats UploadStatistics() const;
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "ChunkStateTable.h"
+
+const char* ChunkStateName(ChunkState state) {
+    switch (state) {
+        case ChunkState::Queued: return "queued";
+        case ChunkState::Generating: return "generating";
+        case ChunkState::Generated: return "generated";
+        case ChunkState::Meshed: return "meshed";
+        case ChunkState::Uploaded: return "uploaded";
+        default: return "unknown";
+    }
+}
+
+ChunkStateTable::Shard& ChunkStateTable::ShardFor(glm::ivec3 coord) {
+    return shards[std::hash<glm::ivec3>()(coord) % ShardCount];
+}
+
+const ChunkStateTable::Shard& ChunkStateTable::ShardFor(glm::ivec3 coord) const {
+    return shards[std::hash<glm::ivec3>()(coord) % ShardCount];
+}
+
+void ChunkStateTable::Count(ChunkState state, int64_t delta) {
+    counts[static_cast<int>(state)].fetch_add(delta, std::memory_order_relaxed);
+}
+
+bool ChunkStateTable::TryInsert(glm::ivec3 coord, ChunkState state) {
+    Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Entry entry;
+    entry.state = state;
+    if (!shard.states.emplace(coord, entry).second) return false;
+    Count(state, 1);
+    return true;
+}
+
+bool ChunkStateTable::Transition(glm::ivec3 coord, ChunkState from, ChunkState to) {
+    Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.states.find(coord);
+    if (it == shard.states.end() || it->second.state != from) return false;
+    it->second.state = to;
+    Count(from, -1);
+    Count(to, 1);
+    return true;
+}
+
+bool ChunkStateTable::Get(glm::ivec3 coord, ChunkState& out) const {
+    const Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.states.find(coord);
+    if (it == shard.states.end()) return false;
+    out = it->second.state;
+    return true;
+}
+
+bool ChunkStateTable::Erase(glm::ivec3 coord) {
+    Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.states.find(coord);
+    if (it == shard.states.end()) return false;
+    Count(it->second.state, -1);
+    shard.states.erase(it);
+    return true;
+}
+
+bool ChunkStateTable::Remove(glm::ivec3 coord, ChunkState expected) {
+    Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.states.find(coord);
+    if (it == shard.states.end() || it->second.state != expected) return false;
+    Count(expected, -1);
+    shard.states.erase(it);
+    return true;
+}
+
+bool ChunkStateTable::UpdateNeighborMask(glm::ivec3 coord, uint8_t mask) {
+    Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.states.find(coord);
+    if (it == shard.states.end()) return false;
+    Entry& entry = it->second;
+    if (entry.hasNeighborMask && (mask & entry.neighborMask) != entry.neighborMask) return false;
+    entry.neighborMask = mask;
+    entry.hasNeighborMask = true;
+    return true;
+}
+
+bool ChunkStateTable::GetNeighborMask(glm::ivec3 coord, uint8_t& out) const {
+    const Shard& shard = ShardFor(coord);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.states.find(coord);
+    if (it == shard.states.end() || !it->second.hasNeighborMask) return false;
+    out = it->second.neighborMask;
+    return true;
+}
+
+size_t ChunkStateTable::EraseIf(const std::function<bool(glm::ivec3, ChunkState)>& predicate) {
+    size_t erased = 0;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.states.begin(); it != shard.states.end(); ) {
+            if (predicate(it->first, it->second.state)) {
+                Count(it->second.state, -1);
+                it = shard.states.erase(it);
+                ++erased;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return erased;
+}
+
+ChunkStateTable::Counts ChunkStateTable::GetCounts() const {
+    Counts out{};
+    for (int i = 0; i < StateCount; ++i) {
+        int64_t n = counts[i].load(std::memory_order_relaxed);
+        out[i] = n > 0 ? static_cast<size_t>(n) : 0;
+    }
+    return out;
+}
@@ -0,0 +1,76 @@
+#ifndef CHUNKSTATETABLE_H
+#define CHUNKSTATETABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+// Lifecycle of a chunk from the moment ChunkManager asks for it until its
+// mesh is on the GPU. A chunk with no entry is neither wanted nor loaded.
+enum class ChunkState : uint8_t {
+    Queued,
+    Generating,
+    Generated,
+    Meshed,
+    Uploaded,
+    Count
+};
+
+const char* ChunkStateName(ChunkState state);
+
+// Concurrent coord -> state map split into independently locked shards so
+// workers moving different chunks along rarely contend. Per-state totals
+// are kept in atomics for cheap reads from the main thread.
+class ChunkStateTable {
+public:
+    static constexpr int StateCount = static_cast<int>(ChunkState::Count);
+    using Counts = std::array<size_t, StateCount>;
+private:
+    static constexpr int ShardCount = 16;
+    struct Entry {
+        ChunkState state;
+        // Which of the six neighbours the chunk's current mesh saw; only
+        // valid once hasNeighborMask is set.
+        uint8_t neighborMask = 0;
+        bool hasNeighborMask = false;
+    };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<glm::ivec3, Entry> states;
+    };
+    std::array<Shard, ShardCount> shards;
+    std::array<std::atomic<int64_t>, StateCount> counts{};
+
+    Shard& ShardFor(glm::ivec3 coord);
+    const Shard& ShardFor(glm::ivec3 coord) const;
+    void Count(ChunkState state, int64_t delta);
+public:
+    // Adds coord in the given state; false if it already has an entry.
+    bool TryInsert(glm::ivec3 coord, ChunkState state);
+    // Moves coord from one state to the next; false (and no change) if the
+    // entry is missing or in any other state, e.g. because it was dropped
+    // and requested again while a job was still running.
+    bool Transition(glm::ivec3 coord, ChunkState from, ChunkState to);
+    bool Get(glm::ivec3 coord, ChunkState& out) const;
+    bool Erase(glm::ivec3 coord);
+    // Erases coord only while it is still in the given state.
+    bool Remove(glm::ivec3 coord, ChunkState expected);
+    // Records the neighbour mask of a new mesh unless the stored one has a
+    // neighbour this mask lacks (an older mesh finishing late). False if
+    // coord has no entry or the mask was not stored.
+    bool UpdateNeighborMask(glm::ivec3 coord, uint8_t mask);
+    // False if coord has no entry or has not been meshed yet.
+    bool GetNeighborMask(glm::ivec3 coord, uint8_t& out) const;
+    // Removes every entry the predicate accepts; returns how many.
+    size_t EraseIf(const std::function<bool(glm::ivec3, ChunkState)>& predicate);
+    Counts GetCounts() const;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "ChunkStore.h"
+#include <algorithm>
+#include <mutex>
+
+static int WrapIndex(int v, int n) {
+    int m = v % n;
+    return m < 0 ? m + n : m;
+}
+
+ChunkStore::ChunkStore(int radius) {
+    Recenter(glm::ivec3(0), radius);
+}
+
+size_t ChunkStore::SlotIndex(glm::ivec3 coord, int sideLength) const {
+    return static_cast<size_t>(WrapIndex(coord.x, sideLength))
+         + static_cast<size_t>(sideLength) * (WrapIndex(coord.y, sideLength) + static_cast<size_t>(sideLength) * WrapIndex(coord.z, sideLength));
+}
+
+// Locks the stripe owning coord's slot and returns the slot index, retrying
+// if the window was resized between computing the index and locking.
+template <typename Lock>
+size_t ChunkStore::LockSlot(glm::ivec3 coord, Lock& lock) const {
+    for (;;) {
+        int sideLength = side.load(std::memory_order_acquire);
+        size_t index = SlotIndex(coord, sideLength);
+        lock = Lock(locks[index % LockStripes]);
+        if (side.load(std::memory_order_relaxed) == sideLength) return index;
+        lock.unlock();
+    }
+}
+
+bool ChunkStore::InWindow(glm::ivec3 coord) const {
+    glm::ivec3 delta = glm::abs(coord - center);
+    return std::max({delta.x, delta.y, delta.z}) <= radius;
+}
+
+ChunkRef ChunkStore::Get(glm::ivec3 coord) const {
+    std::shared_lock<std::shared_mutex> lock;
+    size_t index = LockSlot(coord, lock);
+    const Slot& slot = slots[index];
+    return (slot.chunk && slot.coord == coord) ? slot.chunk : nullptr;
+}
+
+bool ChunkStore::Contains(glm::ivec3 coord) const {
+    std::shared_lock<std::shared_mutex> lock;
+    size_t index = LockSlot(coord, lock);
+    const Slot& slot = slots[index];
+    return slot.chunk && slot.coord == coord;
+}
+
+bool ChunkStore::Put(glm::ivec3 coord, ChunkRef chunk) {
+    ChunkRef previous;
+    std::unique_lock<std::shared_mutex> lock;
+    size_t index = LockSlot(coord, lock);
+    // The window only changes with every stripe held, so it is stable here.
+    if (!InWindow(coord)) return false;
+    Slot& slot = slots[index];
+    // Release the old chunk after unlocking; it may be the last reference.
+    previous = std::move(slot.chunk);
+    slot.coord = coord;
+    slot.chunk = std::move(chunk);
+    return true;
+}
+
+bool ChunkStore::Erase(glm::ivec3 coord) {
+    ChunkRef previous;
+    std::unique_lock<std::shared_mutex> lock;
+    size_t index = LockSlot(coord, lock);
+    Slot& slot = slots[index];
+    if (!slot.chunk || slot.coord != coord) return false;
+    previous = std::move(slot.chunk);
+    return true;
+}
+
+bool ChunkStore::Erase(glm::ivec3 coord, const ChunkRef& expected) {
+    ChunkRef previous;
+    std::unique_lock<std::shared_mutex> lock;
+    size_t index = LockSlot(coord, lock);
+    Slot& slot = slots[index];
+    if (!slot.chunk || slot.coord != coord || slot.chunk != expected) return false;
+    previous = std::move(slot.chunk);
+    return true;
+}
+
+std::vector<glm::ivec3> ChunkStore::Recenter(glm::ivec3 newCenter, int newRadius) {
+    std::vector<glm::ivec3> removed;
+    std::vector<ChunkRef> released;
+    std::array<std::unique_lock<std::shared_mutex>, LockStripes> held;
+    for (int i = 0; i < LockStripes; ++i) {
+        held[i] = std::unique_lock<std::shared_mutex>(locks[i]);
+    }
+    if (newRadius != radius || slots.empty()) {
+        // New size: every chunk would land in a different slot, so drop
+        // them all and let the manager regenerate.
+        for (Slot& slot : slots) {
+            if (!slot.chunk) continue;
+            removed.push_back(slot.coord);
+            released.push_back(std::move(slot.chunk));
+        }
+        radius = std::max(0, newRadius);
+        int sideLength = 2 * radius + 1;
+        slots.clear();
+        slots.resize(static_cast<size_t>(sideLength) * sideLength * sideLength);
+        side.store(sideLength, std::memory_order_release);
+        center = newCenter;
+        return removed;
+    }
+    center = newCenter;
+    for (Slot& slot : slots) {
+        if (!slot.chunk || InWindow(slot.coord)) continue;
+        removed.push_back(slot.coord);
+        released.push_back(std::move(slot.chunk));
+    }
+    return removed;
+}
+
+size_t ChunkStore::Size() const {
+    size_t total = 0;
+    std::array<std::shared_lock<std::shared_mutex>, LockStripes> held;
+    for (int i = 0; i < LockStripes; ++i) {
+        held[i] = std::shared_lock<std::shared_mutex>(locks[i]);
+    }
+    for (const Slot& slot : slots) {
+        if (slot.chunk) ++total;
+    }
+    return total;
+}
+
+size_t ChunkStore::Capacity() const {
+    return slots.size();
+}
@@ -0,0 +1,60 @@
+#ifndef CHUNKSTORE_H
+#define CHUNKSTORE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../Chunk/Chunk.h"
+
+// Chunks are immutable once stored. Holding a ChunkRef keeps the chunk alive
+// even if the store erases or replaces it meanwhile.
+using ChunkRef = std::shared_ptr<const Chunk>;
+
+// Loaded chunks as a cube window of the given radius around a centre chunk,
+// kept in a preallocated 3D ring indexed by coord mod side. Lookups are a
+// few integer ops with no hashing. When the centre moves, slots that leave
+// the window are cleared in place and reused by the chunks that enter it.
+// Slots are guarded by striped reader/writer locks so workers read
+// concurrently; moving the window takes every stripe.
+class ChunkStore {
+private:
+    struct Slot {
+        glm::ivec3 coord{0};
+        ChunkRef chunk;
+    };
+    static constexpr int LockStripes = 64;
+    // Slots in x-fastest order, so the +-x neighbours share cache lines.
+    std::vector<Slot> slots;
+    mutable std::array<std::shared_mutex, LockStripes> locks;
+    glm::ivec3 center{0};
+    int radius = 0;
+    // Read before locking to find the stripe, so it is atomic.
+    std::atomic<int> side{1};
+
+    size_t SlotIndex(glm::ivec3 coord, int sideLength) const;
+    template <typename Lock>
+    size_t LockSlot(glm::ivec3 coord, Lock& lock) const;
+    bool InWindow(glm::ivec3 coord) const;
+public:
+    explicit ChunkStore(int radius = 1);
+    // Null when the chunk is not loaded.
+    ChunkRef Get(glm::ivec3 coord) const;
+    bool Contains(glm::ivec3 coord) const;
+    // False (and nothing stored) when coord lies outside the window.
+    bool Put(glm::ivec3 coord, ChunkRef chunk);
+    bool Erase(glm::ivec3 coord);
+    // Erases only while the slot still holds `expected`, so a job can take
+    // back its own chunk without touching one stored after it.
+    bool Erase(glm::ivec3 coord, const ChunkRef& expected);
+    // Moves or resizes the window and returns the coordinates of chunks
+    // that fell out of it.
+    std::vector<glm::ivec3> Recenter(glm::ivec3 newCenter, int newRadius);
+    size_t Size() const;
+    size_t Capacity() const;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "Clipmap.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+static int WrapIndex(int v, int n) {
+    int m = v % n;
+    return m < 0 ? m + n : m;
+}
+
+Clipmap::Clipmap(HeightSampler sampler, int levels, int size, int baseSpacing)
+    : sampler(std::move(sampler)), levels(std::min(std::max(levels, 1), MaxLevels)), size(size | 1), baseSpacing(baseSpacing) {
+    if (size % 2 == 0) {
+        std::cerr << "Clipmap size must be odd, using " << this->size << "\n";
+    }
+}
+
+// Samples a rectangle of grid vertices and queues it as texture updates,
+// split where it wraps around the texture.
+void Clipmap::Sample(int level, glm::ivec2 gridMin, glm::ivec2 gridSize) {
+    if (gridSize.x <= 0 || gridSize.y <= 0) return;
+    int spacing = Spacing(level);
+    scratch.resize(static_cast<size_t>(gridSize.x) * gridSize.y);
+    sampler(gridMin * spacing, spacing, gridSize, scratch.data());
+    samplesTaken += scratch.size();
+
+    glm::ivec2 start(WrapIndex(gridMin.x, size), WrapIndex(gridMin.y, size));
+    int splitX = std::min(gridSize.x, size - start.x);
+    int splitZ = std::min(gridSize.y, size - start.y);
+    int xs[2][2] = {{0, splitX}, {splitX, gridSize.x}};
+    int zs[2][2] = {{0, splitZ}, {splitZ, gridSize.y}};
+    for (auto& z : zs) {
+        for (auto& x : xs) {
+            if (x[1] <= x[0] || z[1] <= z[0]) continue;
+            ClipmapUpdate update;
+            update.level = level;
+            update.texel = glm::ivec2(WrapIndex(start.x + x[0], size), WrapIndex(start.y + z[0], size));
+            update.size = glm::ivec2(x[1] - x[0], z[1] - z[0]);
+            update.heights.reserve(static_cast<size_t>(update.size.x) * update.size.y);
+            for (int lz = z[0]; lz < z[1]; ++lz) {
+                for (int lx = x[0]; lx < x[1]; ++lx) {
+                    update.heights.push_back(static_cast<float>(scratch[lx + lz * gridSize.x]));
+                }
+            }
+            updates.push_back(std::move(update));
+        }
+    }
+}
+
+void Clipmap::Update(glm::vec2 cameraXZ) {
+    int half = (size - 1) / 2;
+    for (int level = 0; level < levels; ++level) {
+        int spacing = Spacing(level);
+        glm::ivec2 centre(static_cast<int>(std::floor(cameraXZ.x / spacing)),
+                          static_cast<int>(std::floor(cameraXZ.y / spacing)));
+        glm::ivec2 origin = centre - half;
+        origin -= glm::ivec2(WrapIndex(origin.x, 2), WrapIndex(origin.y, 2));
+        Level& state = levelState[level];
+        if (state.valid && origin == state.origin) continue;
+
+        glm::ivec2 shift = origin - state.origin;
+        if (!state.valid || std::abs(shift.x) >= size || std::abs(shift.y) >= size) {
+            Sample(level, origin, glm::ivec2(size));
+        } else {
+            // Columns that scrolled in span the whole new grid; rows only
+            // the part of it the old grid shared.
+            int columns = std::abs(shift.x);
+            int columnMin = shift.x > 0 ? origin.x + size - columns : origin.x;
+            Sample(level, glm::ivec2(columnMin, origin.y), glm::ivec2(columns, size));
+            int rows = std::abs(shift.y);
+            int rowMin = shift.y > 0 ? origin.y + size - rows : origin.y;
+            int keptMin = shift.x > 0 ? origin.x : origin.x + columns;
+            Sample(level, glm::ivec2(keptMin, rowMin), glm::ivec2(size - columns, rows));
+        }
+        state.origin = origin;
+        state.valid = true;
+    }
+}
+
+void Clipmap::TakeUpdates(std::vector<ClipmapUpdate>& out) {
+    for (auto& update : updates) out.push_back(std::move(update));
+    updates.clear();
+}
+
+int Clipmap::Levels() const {
+    return levels;
+}
+
+int Clipmap::Size() const {
+    return size;
+}
+
+int Clipmap::Spacing(int level) const {
+    return baseSpacing << level;
+}
+
+glm::ivec2 Clipmap::Origin(int level) const {
+    return levelState[level].origin;
+}
+
+glm::ivec2 Clipmap::TexelOrigin(int level) const {
+    glm::ivec2 origin = levelState[level].origin;
+    return glm::ivec2(WrapIndex(origin.x, size), WrapIndex(origin.y, size));
+}
+
+glm::vec2 Clipmap::FootprintMin(int level) const {
+    return glm::vec2(levelState[level].origin * Spacing(level));
+}
+
+glm::vec2 Clipmap::FootprintMax(int level) const {
+    return glm::vec2((levelState[level].origin + (size - 1)) * Spacing(level));
+}
+
+size_t Clipmap::SamplesTaken() const {
+    return samplesTaken;
+}
@@ -0,0 +1,71 @@
+#ifndef CLIPMAP_H
+#define CLIPMAP_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Fills a size.x by size.y grid of terrain heights starting at block
+// (x, z) = origin, stride blocks apart, x-fastest; World::sampleHeights.
+using HeightSampler = std::function<void(glm::ivec2 origin, int stride, glm::ivec2 size, int* heights)>;
+
+// Heights that changed in one level's texture, a rectangle of texels that
+// does not cross the texture's wrap. x-fastest.
+struct ClipmapUpdate {
+    int level = 0;
+    glm::ivec2 texel{0};
+    glm::ivec2 size{0};
+    std::vector<float> heights;
+};
+
+// Far terrain as nested square heightfield grids (a geometry clipmap).
+// Level L samples the terrain every baseSpacing << L blocks on a grid of
+// Size() x Size() vertices around the camera, so every level costs the
+// same and each one reaches twice as far as the last. A level's heights
+// live in a toroidally addressed texture: when the camera moves, only the
+// rows and columns that scrolled into the grid are sampled and uploaded.
+// Level origins stay on even vertices so each level's samples are also
+// samples of the next, which lets the vertex shader blend a level into the
+// coarser one at its edge without cracks. Main thread only.
+class Clipmap {
+public:
+    static constexpr int MaxLevels = 8;
+private:
+    struct Level {
+        // Grid coordinate of vertex (0, 0), in the level's spacing.
+        glm::ivec2 origin{0};
+        bool valid = false;
+    };
+    HeightSampler sampler;
+    int levels;
+    int size;
+    int baseSpacing;
+    std::array<Level, MaxLevels> levelState;
+    std::vector<ClipmapUpdate> updates;
+    std::vector<int> scratch;
+    size_t samplesTaken = 0;
+
+    void Sample(int level, glm::ivec2 gridMin, glm::ivec2 gridSize);
+public:
+    // size is the vertex count per side and must be odd.
+    Clipmap(HeightSampler sampler, int levels = 6, int size = 129, int baseSpacing = 16);
+    // Scrolls every level to stay centred on the camera and queues the
+    // heights that came into view.
+    void Update(glm::vec2 cameraXZ);
+    // Moves the queued texture updates into out.
+    void TakeUpdates(std::vector<ClipmapUpdate>& out);
+    int Levels() const;
+    int Size() const;
+    int Spacing(int level) const;
+    glm::ivec2 Origin(int level) const;
+    // Texel holding vertex (0, 0) of the level.
+    glm::ivec2 TexelOrigin(int level) const;
+    // Block-space square the level's grid covers, min and max inclusive.
+    glm::vec2 FootprintMin(int level) const;
+    glm::vec2 FootprintMax(int level) const;
+    size_t SamplesTaken() const;
+};
+
+#endif
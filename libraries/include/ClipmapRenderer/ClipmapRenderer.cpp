@@ -0,0 +1,115 @@
+#include "ClipmapRenderer.h"
+
+// Texture units 0 and 1 hold the sky cube map and the chunk quad buffer.
+static constexpr GLint heightTextureUnit = 2;
+
+void ClipmapRenderer::Initialize(const Clipmap& clipmap, const Shader& shader) {
+    levels = clipmap.Levels();
+    size = clipmap.Size();
+
+    std::vector<GLuint> grid;
+    grid.reserve(static_cast<size_t>(size) * size * 2);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            grid.push_back(static_cast<GLuint>(x));
+            grid.push_back(static_cast<GLuint>(z));
+        }
+    }
+    std::vector<GLuint> indices;
+    indices.reserve(static_cast<size_t>(size - 1) * (size - 1) * 6);
+    for (int z = 0; z + 1 < size; ++z) {
+        for (int x = 0; x + 1 < size; ++x) {
+            GLuint v00 = static_cast<GLuint>(x + z * size);
+            GLuint v10 = v00 + 1;
+            GLuint v01 = v00 + static_cast<GLuint>(size);
+            GLuint v11 = v01 + 1;
+            // Counter-clockwise seen from above.
+            indices.insert(indices.end(), {v00, v01, v10, v10, v01, v11});
+        }
+    }
+    indexCount = static_cast<GLsizei>(indices.size());
+
+    vao.Refresh();
+    vao.Bind();
+    vbo.Allocate(static_cast<GLsizeiptr>(grid.size() * sizeof(GLuint)), GL_STATIC_DRAW);
+    vbo.SubData(0, static_cast<GLsizeiptr>(grid.size() * sizeof(GLuint)), grid.data());
+    ebo.Refresh(indices.data(), indices.size() * sizeof(GLuint), GL_STATIC_DRAW);
+    vao.LinkUIntVbo(vbo, 0, 2, 2, (void*)0);
+    vao.Unbind();
+    ebo.Unbind();
+
+    glGenTextures(1, &heightTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R32F, size, size, levels, 0, GL_RED, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    levelLoc = glGetUniformLocation(shader.ID, "uLevel");
+    sizeLoc = glGetUniformLocation(shader.ID, "uSize");
+    spacingLoc = glGetUniformLocation(shader.ID, "uSpacing");
+    originLoc = glGetUniformLocation(shader.ID, "uOrigin");
+    texelOriginLoc = glGetUniformLocation(shader.ID, "uTexelOrigin");
+    morphLoc = glGetUniformLocation(shader.ID, "uMorph");
+    innerMinLoc = glGetUniformLocation(shader.ID, "uInnerMin");
+    innerMaxLoc = glGetUniformLocation(shader.ID, "uInnerMax");
+    heightsLoc = glGetUniformLocation(shader.ID, "uHeights");
+    sunNormalLoc = glGetUniformLocation(shader.ID, "aSunNormal");
+}
+
+void ClipmapRenderer::Upload(const Clipmap& clipmap, const Shader& shader, const std::vector<ClipmapUpdate>& updates) {
+    if (vao.ID == 0) Initialize(clipmap, shader);
+    if (updates.empty()) return;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (const auto& update : updates) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, update.texel.x, update.texel.y, update.level,
+                        update.size.x, update.size.y, 1, GL_RED, GL_FLOAT, update.heights.data());
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void ClipmapRenderer::Draw(const Clipmap& clipmap, glm::vec3 sunNormal) {
+    if (vao.ID == 0) return;
+    glActiveTexture(GL_TEXTURE0 + heightTextureUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glUniform1i(heightsLoc, heightTextureUnit);
+    glUniform1i(sizeLoc, size);
+    glUniform3f(sunNormalLoc, sunNormal.x, sunNormal.y, sunNormal.z);
+    vao.Bind();
+    ebo.Bind();
+    for (int level = 0; level < levels; ++level) {
+        glm::ivec2 origin = clipmap.Origin(level);
+        glm::ivec2 texelOrigin = clipmap.TexelOrigin(level);
+        glUniform1i(levelLoc, level);
+        glUniform1i(spacingLoc, clipmap.Spacing(level));
+        glUniform2i(originLoc, origin.x, origin.y);
+        glUniform2i(texelOriginLoc, texelOrigin.x, texelOrigin.y);
+        // The outermost level has nothing coarser to blend into.
+        glUniform1i(morphLoc, level + 1 < levels ? 1 : 0);
+        if (level > 0) {
+            glm::vec2 innerMin = clipmap.FootprintMin(level - 1);
+            glm::vec2 innerMax = clipmap.FootprintMax(level - 1);
+            glUniform2f(innerMinLoc, innerMin.x, innerMin.y);
+            glUniform2f(innerMaxLoc, innerMax.x, innerMax.y);
+        } else {
+            glUniform2f(innerMinLoc, 0.0f, 0.0f);
+            glUniform2f(innerMaxLoc, 0.0f, 0.0f);
+        }
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)0);
+    }
+    vao.Unbind();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void ClipmapRenderer::Delete() {
+    if (heightTexture != 0) glDeleteTextures(1, &heightTexture);
+    heightTexture = 0;
+    if (ebo.ID != 0) ebo.Delete();
+    if (vbo.ID != 0) vbo.Delete();
+    if (vao.ID != 0) vao.Delete();
+    ebo.ID = 0;
+    vbo.ID = 0;
+    vao.ID = 0;
+}
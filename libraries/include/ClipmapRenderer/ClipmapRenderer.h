@@ -0,0 +1,45 @@
+#ifndef CLIPMAP_RENDERER_H
+#define CLIPMAP_RENDERER_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "../glad/glad.h"
+#include "../VAO/VAO.h"
+#include "../VBO/VBO.h"
+#include "../EBO/EBO.h"
+#include "../shader/shader_class.h"
+#include "../Clipmap/Clipmap.h"
+
+// Draws a Clipmap with clipmap.vert/.frag. Every level reuses one static
+// grid mesh; the vertex shader places it and reads its heights from one
+// layer of a texture array, so moving the camera only uploads the texels
+// Clipmap::Update resampled. Each level discards what the finer level
+// inside it draws.
+class ClipmapRenderer {
+private:
+    int levels = 0;
+    int size = 0;
+    GLsizei indexCount = 0;
+    VAO vao;
+    VBO vbo;
+    EBO ebo;
+    GLuint heightTexture = 0;
+    GLint levelLoc = -1;
+    GLint sizeLoc = -1;
+    GLint spacingLoc = -1;
+    GLint originLoc = -1;
+    GLint texelOriginLoc = -1;
+    GLint morphLoc = -1;
+    GLint innerMinLoc = -1;
+    GLint innerMaxLoc = -1;
+    GLint heightsLoc = -1;
+    GLint sunNormalLoc = -1;
+    void Initialize(const Clipmap& clipmap, const Shader& shader);
+public:
+    void Upload(const Clipmap& clipmap, const Shader& shader, const std::vector<ClipmapUpdate>& updates);
+    // Expects the shader active with its view and projection set.
+    void Draw(const Clipmap& clipmap, glm::vec3 sunNormal);
+    void Delete();
+};
+
+#endif
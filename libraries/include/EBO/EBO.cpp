@@ -13,6 +13,16 @@ void EBO::Refresh(const void* data, size_t size, GLenum usage) {
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, usage);
 }
 
+void EBO::Allocate(GLsizeiptr size, GLenum usage) {
+    glGenBuffers(1, &ID);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, nullptr, usage);
+}
+
+void EBO::SubData(GLintptr offset, GLsizeiptr size, const void* data) {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data);
+}
 
 
 EBO::EBO(GLuint* vertices , GLsizeiptr size , GLuint usage){
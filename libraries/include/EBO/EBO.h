@@ -1,10 +1,17 @@
 #ifndef EBO_H
 #define EBO_H
 
-#define GLFW_INCLUDE_NONE
 #include "../glad/glad.h"
-#include <GLFW/glfw3.h>
 
+// Same layout as DrawElementsIndirectCommand so the list can be handed to
+// glMultiDrawElementsIndirect once the loader exposes GL 4.3.
+struct DrawElementsCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
 
 class EBO{
 public:
@@ -12,6 +19,8 @@ public:
     EBO();
     EBO(GLuint* indices , GLsizeiptr size , GLuint usage);
     void Refresh(const void* data, size_t size, GLenum usage) ;
+    void Allocate(GLsizeiptr size, GLenum usage);
+    void SubData(GLintptr offset, GLsizeiptr size, const void* data);
     void Bind();
     void Unbind();
     void Delete();
@@ -0,0 +1,72 @@
+#include "FrameBudget.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Frames within this much of the target count as on time; vsync jitter
+// alone should not shrink the budgets.
+static constexpr double overrunSlack = 1.1;
+static constexpr double backoff = 0.1;
+static constexpr double recovery = 0.01;
+
+FrameBudget::FrameBudget(double targetMs) : targetMs(targetMs) {
+}
+
+void FrameBudget::EndFrame(double frameSeconds, bool backlogged) {
+    double ms = frameSeconds * 1000.0;
+    history[recorded % historySize] = ms;
+    recorded++;
+    if (ms > targetMs * overrunSlack) {
+        level = std::max(0.0, level - backoff);
+    } else if (backlogged) {
+        level = std::min(1.0, level + recovery);
+    }
+}
+
+static size_t Interpolate(size_t lo, size_t hi, double t) {
+    double ratio = static_cast<double>(hi) / static_cast<double>(std::max<size_t>(lo, 1));
+    return static_cast<size_t>(static_cast<double>(lo) * std::pow(ratio, t));
+}
+
+size_t FrameBudget::UploadBytes() const {
+    return Interpolate(minUploadBytes, maxUploadBytes, level);
+}
+
+size_t FrameBudget::ScanCoords() const {
+    return Interpolate(minScanCoords, maxScanCoords, level);
+}
+
+double FrameBudget::Level() const {
+    return level;
+}
+
+double FrameBudget::TargetMs() const {
+    return targetMs;
+}
+
+void FrameBudget::SetTargetMs(double ms) {
+    targetMs = ms;
+}
+
+void FrameBudget::SetUploadRange(size_t minBytes, size_t maxBytes) {
+    minUploadBytes = minBytes;
+    maxUploadBytes = std::max(minBytes, maxBytes);
+}
+
+void FrameBudget::SetScanRange(size_t minCoords, size_t maxCoords) {
+    minScanCoords = minCoords;
+    maxScanCoords = std::max(minCoords, maxCoords);
+}
+
+FrameStats FrameBudget::Stats() const {
+    FrameStats stats;
+    stats.frames = recorded;
+    size_t count = std::min(recorded, historySize);
+    if (count == 0) return stats;
+    std::vector<double> sorted(history.begin(), history.begin() + count);
+    std::sort(sorted.begin(), sorted.end());
+    stats.p50Ms = sorted[(count - 1) / 2];
+    stats.p99Ms = sorted[std::min(count - 1, count * 99 / 100)];
+    stats.maxMs = sorted.back();
+    return stats;
+}
@@ -0,0 +1,48 @@
+#ifndef FRAME_BUDGET_H
+#define FRAME_BUDGET_H
+
+#include <array>
+#include <cstddef>
+
+struct FrameStats {
+    size_t frames = 0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// Sizes the per-frame streaming work (mesh upload bytes, chunk coordinates
+// scanned) from measured frame times. A single level in [0, 1] places each
+// budget geometrically between its minimum and maximum. A frame over the
+// target drops the level sharply; a frame that fit while work was still
+// waiting raises it a little. Frames with nothing waiting say nothing about
+// the budget and leave it alone, so idle time does not inflate it before
+// the next burst.
+class FrameBudget {
+private:
+    static constexpr size_t historySize = 256;
+    std::array<double, historySize> history{};
+    size_t recorded = 0;
+    double targetMs;
+    double level = 0.5;
+    size_t minUploadBytes = 64 << 10;
+    size_t maxUploadBytes = 8 << 20;
+    size_t minScanCoords = 512;
+    size_t maxScanCoords = 32768;
+public:
+    explicit FrameBudget(double targetMs = 1000.0 / 60.0);
+    // Feeds the duration of the frame that just finished and whether it
+    // left streaming work queued for lack of budget.
+    void EndFrame(double frameSeconds, bool backlogged);
+    size_t UploadBytes() const;
+    size_t ScanCoords() const;
+    double Level() const;
+    double TargetMs() const;
+    void SetTargetMs(double ms);
+    void SetUploadRange(size_t minBytes, size_t maxBytes);
+    void SetScanRange(size_t minCoords, size_t maxCoords);
+    // Percentiles over the most recent frames.
+    FrameStats Stats() const;
+};
+
+#endif
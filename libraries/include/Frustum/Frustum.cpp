@@ -0,0 +1,111 @@
+#include "./Frustum.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+Frustum Frustum::FromMatrix(const glm::mat4& m) {
+    Frustum f;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+    f.planes[0] = row3 + row0;
+    f.planes[1] = row3 - row0;
+    f.planes[2] = row3 + row1;
+    f.planes[3] = row3 - row1;
+    f.planes[4] = row3 + row2;
+    f.planes[5] = row3 - row2;
+    for (auto& p : f.planes) {
+        float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (len > 0.0f) p /= len;
+    }
+    return f;
+}
+
+void ChunkCuller::SetChunks(const std::vector<glm::ivec3>& coords, float chunkSize) {
+    cubeSize = chunkSize;
+    minX.resize(coords.size());
+    minY.resize(coords.size());
+    minZ.resize(coords.size());
+    for (size_t i = 0; i < coords.size(); ++i) {
+        minX[i] = static_cast<float>(coords[i].x) * chunkSize;
+        minY[i] = static_cast<float>(coords[i].y) * chunkSize;
+        minZ[i] = static_cast<float>(coords[i].z) * chunkSize;
+    }
+}
+
+size_t ChunkCuller::Size() const {
+    return minX.size();
+}
+
+void ChunkCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    // A cube is outside a plane when its corner furthest along the plane
+    // normal is behind it. For a cube of edge s at min corner p that corner
+    // is p + s * step(n), so the test folds into dot(n, p) + w < 0 with a
+    // per-plane constant w = d + s * sum(max(n, 0)).
+    float a[6], b[6], c[6], w[6];
+    for (int i = 0; i < 6; ++i) {
+        const glm::vec4& p = frustum.planes[i];
+        a[i] = p.x;
+        b[i] = p.y;
+        c[i] = p.z;
+        w[i] = p.w + cubeSize * (std::max(p.x, 0.0f) + std::max(p.y, 0.0f) + std::max(p.z, 0.0f));
+    }
+    const size_t count = minX.size();
+    size_t i = 0;
+#if defined(__AVX__)
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(&minX[i]);
+        __m256 y = _mm256_loadu_ps(&minY[i]);
+        __m256 z = _mm256_loadu_ps(&minZ[i]);
+        __m256 outside = zero;
+        for (int p = 0; p < 6; ++p) {
+            __m256 dist = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(a[p])), _mm256_mul_ps(y, _mm256_set1_ps(b[p]))),
+                _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(c[p])), _mm256_set1_ps(w[p])));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+        }
+        unsigned inside = ~static_cast<unsigned>(_mm256_movemask_ps(outside)) & 0xFFu;
+        while (inside) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(inside));
+            visible.push_back(static_cast<uint32_t>(i + bit));
+            inside &= inside - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(&minX[i]);
+        __m128 y = _mm_loadu_ps(&minY[i]);
+        __m128 z = _mm_loadu_ps(&minZ[i]);
+        __m128 outside = zero;
+        for (int p = 0; p < 6; ++p) {
+            __m128 dist = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(a[p])), _mm_mul_ps(y, _mm_set1_ps(b[p]))),
+                _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(c[p])), _mm_set1_ps(w[p])));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+        }
+        unsigned inside = ~static_cast<unsigned>(_mm_movemask_ps(outside)) & 0xFu;
+        while (inside) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(inside));
+            visible.push_back(static_cast<uint32_t>(i + bit));
+            inside &= inside - 1;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        bool outside = false;
+        for (int p = 0; p < 6; ++p) {
+            if (a[p] * minX[i] + b[p] * minY[i] + c[p] * minZ[i] + w[p] < 0.0f) {
+                outside = true;
+                break;
+            }
+        }
+        if (!outside) visible.push_back(static_cast<uint32_t>(i));
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+
+// Planes are stored as (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside.
+struct Frustum {
+    glm::vec4 planes[6];
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+};
+
+// Tests axis-aligned cubes of one fixed size against a frustum. Cube
+// minimum corners are kept as separate x/y/z arrays so the test runs over
+// several chunks per SIMD instruction.
+class ChunkCuller {
+private:
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    float cubeSize = 1.0f;
+public:
+    void SetChunks(const std::vector<glm::ivec3>& coords, float chunkSize);
+    size_t Size() const;
+    // Appends the indices (into the SetChunks list) of every cube that is
+    // at least partially inside the frustum.
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+};
+
+#endif
@@ -0,0 +1,288 @@
+#include "./HeightNoise.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEIGHTNOISE_X86 1
+#endif
+
+// noise2D is noise3D on a fixed z plane, so the z terms are constants.
+static const float kPlaneZ = static_cast<float>(SIVPERLIN_DEFAULT_Z) - std::floor(static_cast<float>(SIVPERLIN_DEFAULT_Z));
+
+static float Fade(float t) {
+    return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+static float Lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+static float Grad(int32_t hash, float x, float y, float z) {
+    int32_t h = hash & 15;
+    float u = h < 8 ? x : y;
+    float v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+}
+
+static float Noise2D(const int32_t* perm, float x, float y) {
+    float x0 = std::floor(x);
+    float y0 = std::floor(y);
+    int32_t ix = static_cast<int32_t>(x0) & 255;
+    int32_t iy = static_cast<int32_t>(y0) & 255;
+    float fx = x - x0;
+    float fy = y - y0;
+    float fz = kPlaneZ;
+    float u = Fade(fx);
+    float v = Fade(fy);
+    float w = Fade(fz);
+    int32_t a = (perm[ix] + iy) & 255;
+    int32_t b = (perm[ix + 1] + iy) & 255;
+    int32_t aa = perm[a];
+    int32_t ab = perm[a + 1];
+    int32_t ba = perm[b];
+    int32_t bb = perm[b + 1];
+    float p0 = Grad(perm[aa], fx, fy, fz);
+    float p1 = Grad(perm[ba], fx - 1, fy, fz);
+    float p2 = Grad(perm[ab], fx, fy - 1, fz);
+    float p3 = Grad(perm[bb], fx - 1, fy - 1, fz);
+    float p4 = Grad(perm[aa + 1], fx, fy, fz - 1);
+    float p5 = Grad(perm[ba + 1], fx - 1, fy, fz - 1);
+    float p6 = Grad(perm[ab + 1], fx, fy - 1, fz - 1);
+    float p7 = Grad(perm[bb + 1], fx - 1, fy - 1, fz - 1);
+    float r0 = Lerp(Lerp(p0, p1, u), Lerp(p2, p3, u), v);
+    float r1 = Lerp(Lerp(p4, p5, u), Lerp(p6, p7, u), v);
+    return Lerp(r0, r1, w);
+}
+
+static void Octave2DScalar(const int32_t* perm, const float* xs, const float* ys, float* out, size_t begin, size_t count, int octaves, float persistence) {
+    for (size_t i = begin; i < count; ++i) {
+        float x = xs[i];
+        float y = ys[i];
+        float result = 0;
+        float amplitude = 1;
+        for (int o = 0; o < octaves; ++o) {
+            result += Noise2D(perm, x, y) * amplitude;
+            x *= 2;
+            y *= 2;
+            amplitude *= persistence;
+        }
+        out[i] = result;
+    }
+}
+
+#if defined(HEIGHTNOISE_X86)
+
+// The SIMD kernels mirror Noise2D step for step, in the same operation
+// order, so they differ from it only where the compiler contracts the
+// scalar code into fused multiply-adds.
+
+#define SSE41_FN __attribute__((target("sse4.1")))
+#define AVX2_FN __attribute__((target("avx2")))
+
+SSE41_FN static inline __m128i Gather4(const int32_t* perm, __m128i idx) {
+    return _mm_setr_epi32(perm[_mm_extract_epi32(idx, 0)], perm[_mm_extract_epi32(idx, 1)],
+                          perm[_mm_extract_epi32(idx, 2)], perm[_mm_extract_epi32(idx, 3)]);
+}
+
+SSE41_FN static inline __m128 Fade4(__m128 t) {
+    __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    __m128 inner = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    inner = _mm_add_ps(_mm_mul_ps(t, inner), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(t3, inner);
+}
+
+SSE41_FN static inline __m128 Lerp4(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+SSE41_FN static inline __m128 Grad4(__m128i hash, __m128 x, __m128 y, __m128 z) {
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+    __m128 u = _mm_blendv_ps(y, x, _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8))));
+    __m128i xCase = _mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)), _mm_cmpeq_epi32(h, _mm_set1_epi32(14)));
+    __m128 v = _mm_blendv_ps(z, x, _mm_castsi128_ps(xCase));
+    v = _mm_blendv_ps(v, y, _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4))));
+    __m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128 vSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+    return _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
+}
+
+SSE41_FN static inline __m128 Noise4(const int32_t* perm, __m128 x, __m128 y) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i one32 = _mm_set1_epi32(1);
+    const __m128i mask = _mm_set1_epi32(255);
+    __m128 x0 = _mm_floor_ps(x);
+    __m128 y0 = _mm_floor_ps(y);
+    __m128i ix = _mm_and_si128(_mm_cvttps_epi32(x0), mask);
+    __m128i iy = _mm_and_si128(_mm_cvttps_epi32(y0), mask);
+    __m128 fx = _mm_sub_ps(x, x0);
+    __m128 fy = _mm_sub_ps(y, y0);
+    __m128 fz = _mm_set1_ps(kPlaneZ);
+    __m128 fx1 = _mm_sub_ps(fx, one);
+    __m128 fy1 = _mm_sub_ps(fy, one);
+    __m128 fz1 = _mm_sub_ps(fz, one);
+    __m128 u = Fade4(fx);
+    __m128 v = Fade4(fy);
+    __m128 w = _mm_set1_ps(Fade(kPlaneZ));
+    __m128i a = _mm_and_si128(_mm_add_epi32(Gather4(perm, ix), iy), mask);
+    __m128i b = _mm_and_si128(_mm_add_epi32(Gather4(perm, _mm_add_epi32(ix, one32)), iy), mask);
+    __m128i aa = Gather4(perm, a);
+    __m128i ab = Gather4(perm, _mm_add_epi32(a, one32));
+    __m128i ba = Gather4(perm, b);
+    __m128i bb = Gather4(perm, _mm_add_epi32(b, one32));
+    __m128 p0 = Grad4(Gather4(perm, aa), fx, fy, fz);
+    __m128 p1 = Grad4(Gather4(perm, ba), fx1, fy, fz);
+    __m128 p2 = Grad4(Gather4(perm, ab), fx, fy1, fz);
+    __m128 p3 = Grad4(Gather4(perm, bb), fx1, fy1, fz);
+    __m128 p4 = Grad4(Gather4(perm, _mm_add_epi32(aa, one32)), fx, fy, fz1);
+    __m128 p5 = Grad4(Gather4(perm, _mm_add_epi32(ba, one32)), fx1, fy, fz1);
+    __m128 p6 = Grad4(Gather4(perm, _mm_add_epi32(ab, one32)), fx, fy1, fz1);
+    __m128 p7 = Grad4(Gather4(perm, _mm_add_epi32(bb, one32)), fx1, fy1, fz1);
+    __m128 r0 = Lerp4(Lerp4(p0, p1, u), Lerp4(p2, p3, u), v);
+    __m128 r1 = Lerp4(Lerp4(p4, p5, u), Lerp4(p6, p7, u), v);
+    return Lerp4(r0, r1, w);
+}
+
+SSE41_FN static size_t Octave2DSse41(const int32_t* perm, const float* xs, const float* ys, float* out, size_t count, int octaves, float persistence) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 result = _mm_setzero_ps();
+        float amplitude = 1;
+        for (int o = 0; o < octaves; ++o) {
+            result = _mm_add_ps(result, _mm_mul_ps(Noise4(perm, x, y), _mm_set1_ps(amplitude)));
+            x = _mm_add_ps(x, x);
+            y = _mm_add_ps(y, y);
+            amplitude *= persistence;
+        }
+        _mm_storeu_ps(out + i, result);
+    }
+    return i;
+}
+
+AVX2_FN static inline __m256i Gather8(const int32_t* perm, __m256i idx) {
+    return _mm256_i32gather_epi32(perm, idx, 4);
+}
+
+AVX2_FN static inline __m256 Fade8(__m256 t) {
+    __m256 t3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+    __m256 inner = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+    inner = _mm256_add_ps(_mm256_mul_ps(t, inner), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(t3, inner);
+}
+
+AVX2_FN static inline __m256 Lerp8(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+AVX2_FN static inline __m256 Grad8(__m256i hash, __m256 x, __m256 y, __m256 z) {
+    __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+    __m256 u = _mm256_blendv_ps(y, x, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h)));
+    __m256i xCase = _mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)), _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14)));
+    __m256 v = _mm256_blendv_ps(z, x, _mm256_castsi256_ps(xCase));
+    v = _mm256_blendv_ps(v, y, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h)));
+    __m256 uSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 vSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+    return _mm256_add_ps(_mm256_xor_ps(u, uSign), _mm256_xor_ps(v, vSign));
+}
+
+AVX2_FN static inline __m256 Noise8(const int32_t* perm, __m256 x, __m256 y) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i one32 = _mm256_set1_epi32(1);
+    const __m256i mask = _mm256_set1_epi32(255);
+    __m256 x0 = _mm256_floor_ps(x);
+    __m256 y0 = _mm256_floor_ps(y);
+    __m256i ix = _mm256_and_si256(_mm256_cvttps_epi32(x0), mask);
+    __m256i iy = _mm256_and_si256(_mm256_cvttps_epi32(y0), mask);
+    __m256 fx = _mm256_sub_ps(x, x0);
+    __m256 fy = _mm256_sub_ps(y, y0);
+    __m256 fz = _mm256_set1_ps(kPlaneZ);
+    __m256 fx1 = _mm256_sub_ps(fx, one);
+    __m256 fy1 = _mm256_sub_ps(fy, one);
+    __m256 fz1 = _mm256_sub_ps(fz, one);
+    __m256 u = Fade8(fx);
+    __m256 v = Fade8(fy);
+    __m256 w = _mm256_set1_ps(Fade(kPlaneZ));
+    __m256i a = _mm256_and_si256(_mm256_add_epi32(Gather8(perm, ix), iy), mask);
+    __m256i b = _mm256_and_si256(_mm256_add_epi32(Gather8(perm, _mm256_add_epi32(ix, one32)), iy), mask);
+    __m256i aa = Gather8(perm, a);
+    __m256i ab = Gather8(perm, _mm256_add_epi32(a, one32));
+    __m256i ba = Gather8(perm, b);
+    __m256i bb = Gather8(perm, _mm256_add_epi32(b, one32));
+    __m256 p0 = Grad8(Gather8(perm, aa), fx, fy, fz);
+    __m256 p1 = Grad8(Gather8(perm, ba), fx1, fy, fz);
+    __m256 p2 = Grad8(Gather8(perm, ab), fx, fy1, fz);
+    __m256 p3 = Grad8(Gather8(perm, bb), fx1, fy1, fz);
+    __m256 p4 = Grad8(Gather8(perm, _mm256_add_epi32(aa, one32)), fx, fy, fz1);
+    __m256 p5 = Grad8(Gather8(perm, _mm256_add_epi32(ba, one32)), fx1, fy, fz1);
+    __m256 p6 = Grad8(Gather8(perm, _mm256_add_epi32(ab, one32)), fx, fy1, fz1);
+    __m256 p7 = Grad8(Gather8(perm, _mm256_add_epi32(bb, one32)), fx1, fy1, fz1);
+    __m256 r0 = Lerp8(Lerp8(p0, p1, u), Lerp8(p2, p3, u), v);
+    __m256 r1 = Lerp8(Lerp8(p4, p5, u), Lerp8(p6, p7, u), v);
+    return Lerp8(r0, r1, w);
+}
+
+AVX2_FN static size_t Octave2DAvx2(const int32_t* perm, const float* xs, const float* ys, float* out, size_t count, int octaves, float persistence) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 result = _mm256_setzero_ps();
+        float amplitude = 1;
+        for (int o = 0; o < octaves; ++o) {
+            result = _mm256_add_ps(result, _mm256_mul_ps(Noise8(perm, x, y), _mm256_set1_ps(amplitude)));
+            x = _mm256_add_ps(x, x);
+            y = _mm256_add_ps(y, y);
+            amplitude *= persistence;
+        }
+        _mm256_storeu_ps(out + i, result);
+    }
+    return i;
+}
+
+#endif
+
+HeightNoise::HeightNoise(const siv::PerlinNoise& noise) : kernel(BestKernel()) {
+    const auto& state = noise.serialize();
+    for (int i = 0; i < 512; ++i) {
+        perm[i] = state[i & 255];
+    }
+}
+
+HeightNoise::Kernel HeightNoise::BestKernel() {
+#if defined(HEIGHTNOISE_X86)
+    static const Kernel best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Kernel::Avx2;
+        if (__builtin_cpu_supports("sse4.1")) return Kernel::Sse41;
+        return Kernel::Scalar;
+    }();
+    return best;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+void HeightNoise::SetKernel(Kernel k) {
+    kernel = std::min(k, BestKernel());
+}
+
+const char* HeightNoise::KernelName(Kernel k) {
+    switch (k) {
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Sse41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+void HeightNoise::Octave2D(const float* xs, const float* ys, float* out, size_t count, int octaves, float persistence) const {
+    size_t done = 0;
+#if defined(HEIGHTNOISE_X86)
+    if (kernel == Kernel::Avx2) {
+        done = Octave2DAvx2(perm, xs, ys, out, count, octaves, persistence);
+    } else if (kernel == Kernel::Sse41) {
+        done = Octave2DSse41(perm, xs, ys, out, count, octaves, persistence);
+    }
+#endif
+    Octave2DScalar(perm, xs, ys, out, done, count, octaves, persistence);
+}
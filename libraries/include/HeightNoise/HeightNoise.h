@@ -0,0 +1,40 @@
+#ifndef HEIGHTNOISE_H
+#define HEIGHTNOISE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../PerlinNoise-3.0.0/PerlinNoise.hpp"
+
+// Batched 2D fractal noise. Produces siv::PerlinNoise::octave2D for the
+// permutation it was built from, many points per call. The widest kernel
+// the CPU supports is picked at runtime: AVX2 (8 lanes), SSE4.1 (4 lanes),
+// or scalar.
+class HeightNoise {
+public:
+    enum class Kernel {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+private:
+    // The permutation repeated twice so hashed indices up to 511 need no
+    // wrap; 32-bit entries so AVX2 can gather them directly.
+    alignas(32) int32_t perm[512];
+    Kernel kernel;
+public:
+    explicit HeightNoise(const siv::PerlinNoise& noise);
+
+    // out[i] = octave2D(xs[i], ys[i], octaves, persistence).
+    void Octave2D(const float* xs, const float* ys, float* out, size_t count, int octaves, float persistence) const;
+
+    static Kernel BestKernel();
+    Kernel ActiveKernel() const {
+        return kernel;
+    }
+    // Selects a narrower kernel, e.g. to compare them. Requests wider than
+    // BestKernel() are clamped to it.
+    void SetKernel(Kernel k);
+    static const char* KernelName(Kernel k);
+};
+
+#endif
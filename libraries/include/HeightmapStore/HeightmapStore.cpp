@@ -0,0 +1,109 @@
+#include "HeightmapStore.h"
+#include <algorithm>
+#include <thread>
+
+static int WrapIndex(int v, int n) {
+    int m = v % n;
+    return m < 0 ? m + n : m;
+}
+
+HeightmapStore::HeightmapStore(int radius) {
+    rings.emplace_back(new Ring(2 * radius + 1));
+    ring.store(rings.back().get(), std::memory_order_release);
+    this->radius = radius;
+}
+
+HeightmapStore::Tile& HeightmapStore::TileFor(const Ring& r, glm::ivec2 column) {
+    size_t index = static_cast<size_t>(WrapIndex(column.x, r.side))
+                 + static_cast<size_t>(r.side) * WrapIndex(column.y, r.side);
+    return r.tiles[index];
+}
+
+// Moves the tile's sequence from even to odd. Without wait, gives up if
+// another writer holds it.
+bool HeightmapStore::BeginWrite(Tile& tile, uint32_t& sequence, bool wait) {
+    for (;;) {
+        sequence = tile.sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) == 0
+            && tile.sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            std::atomic_thread_fence(std::memory_order_release);
+            return true;
+        }
+        if (!wait) return false;
+        std::this_thread::yield();
+    }
+}
+
+bool HeightmapStore::Get(glm::ivec2 column, ColumnHeights& out) const {
+    const Ring* r = ring.load(std::memory_order_acquire);
+    const Tile& tile = TileFor(*r, column);
+    uint32_t before = tile.sequence.load(std::memory_order_acquire);
+    if (before & 1) return false;
+    if (!tile.filled.load(std::memory_order_relaxed)
+        || tile.x.load(std::memory_order_relaxed) != column.x
+        || tile.z.load(std::memory_order_relaxed) != column.y) {
+        return false;
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i] = tile.heights[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return tile.sequence.load(std::memory_order_relaxed) == before;
+}
+
+void HeightmapStore::Put(glm::ivec2 column, const ColumnHeights& heights) {
+    Ring* r = ring.load(std::memory_order_acquire);
+    Tile& tile = TileFor(*r, column);
+    uint32_t sequence;
+    if (!BeginWrite(tile, sequence, false)) return;
+    tile.x.store(column.x, std::memory_order_relaxed);
+    tile.z.store(column.y, std::memory_order_relaxed);
+    for (size_t i = 0; i < heights.size(); ++i) {
+        tile.heights[i].store(heights[i], std::memory_order_relaxed);
+    }
+    tile.filled.store(true, std::memory_order_relaxed);
+    tile.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void HeightmapStore::Recenter(glm::ivec2 newCenter, int newRadius) {
+    center = newCenter;
+    if (newRadius != radius) {
+        // Tiles are cheap to recompute, so a resize starts empty rather
+        // than racing writers to copy them across.
+        radius = newRadius;
+        rings.emplace_back(new Ring(2 * newRadius + 1));
+        ring.store(rings.back().get(), std::memory_order_release);
+        return;
+    }
+    Ring* r = ring.load(std::memory_order_relaxed);
+    auto outside = [&](const Tile& tile) {
+        glm::ivec2 column(tile.x.load(std::memory_order_relaxed), tile.z.load(std::memory_order_relaxed));
+        glm::ivec2 delta = glm::abs(column - center);
+        return std::max(delta.x, delta.y) > radius;
+    };
+    size_t count = static_cast<size_t>(r->side) * r->side;
+    for (size_t i = 0; i < count; ++i) {
+        Tile& tile = r->tiles[i];
+        if (!tile.filled.load(std::memory_order_relaxed) || !outside(tile)) continue;
+        uint32_t sequence;
+        BeginWrite(tile, sequence, true);
+        // A writer may have replaced the tile since the unlocked check.
+        if (outside(tile)) tile.filled.store(false, std::memory_order_relaxed);
+        tile.sequence.store(sequence + 2, std::memory_order_release);
+    }
+}
+
+size_t HeightmapStore::Size() const {
+    const Ring* r = ring.load(std::memory_order_acquire);
+    size_t count = static_cast<size_t>(r->side) * r->side;
+    size_t filled = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (r->tiles[i].filled.load(std::memory_order_relaxed)) ++filled;
+    }
+    return filled;
+}
+
+size_t HeightmapStore::Capacity() const {
+    const Ring* r = ring.load(std::memory_order_acquire);
+    return static_cast<size_t>(r->side) * r->side;
+}
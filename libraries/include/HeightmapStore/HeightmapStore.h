@@ -0,0 +1,61 @@
+#ifndef HEIGHTMAPSTORE_H
+#define HEIGHTMAPSTORE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../Chunk/Chunk.h"
+
+// Terrain height of each block column in a chunk column, x-fastest.
+using ColumnHeights = std::array<int, CHUNK_SIZE * CHUNK_SIZE>;
+
+// Heightmap tiles for the chunk columns (x, z) around a centre, in a square
+// ring indexed by column mod side, so every vertical chunk of a column
+// shares one tile. Each tile is guarded by a sequence lock: Get copies
+// without taking any lock and reports a miss if a writer got in the way.
+// Put only ever replaces the tile in the column's own slot, and Recenter
+// evicts tiles outside the new window, so memory stays bounded by the ring.
+class HeightmapStore {
+private:
+    struct Tile {
+        // Odd while a writer is filling the tile.
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<bool> filled{false};
+        std::atomic<int> x{0};
+        std::atomic<int> z{0};
+        std::array<std::atomic<int>, CHUNK_SIZE * CHUNK_SIZE> heights;
+    };
+    struct Ring {
+        int side;
+        std::unique_ptr<Tile[]> tiles;
+        explicit Ring(int sideLength) : side(sideLength), tiles(new Tile[static_cast<size_t>(sideLength) * sideLength]) {}
+    };
+    std::atomic<Ring*> ring;
+    // Rings replaced by a resize stay allocated until destruction so
+    // concurrent readers never touch freed tiles. Only Recenter touches
+    // this list.
+    std::vector<std::unique_ptr<Ring>> rings;
+    glm::ivec2 center{0};
+    int radius = 0;
+
+    static Tile& TileFor(const Ring& r, glm::ivec2 column);
+    static bool BeginWrite(Tile& tile, uint32_t& sequence, bool wait);
+public:
+    explicit HeightmapStore(int radius = 1);
+    // Copies the column's heights into out; false if the tile is missing
+    // or was being written during the copy.
+    bool Get(glm::ivec2 column, ColumnHeights& out) const;
+    // Skipped if another thread is writing the same slot.
+    void Put(glm::ivec2 column, const ColumnHeights& heights);
+    // Evicts tiles outside the new window; resizes the ring when the
+    // radius changes. Called from one thread at a time.
+    void Recenter(glm::ivec2 newCenter, int newRadius);
+    size_t Size() const;
+    size_t Capacity() const;
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "JobSystem.h"
+
+// Index of the current thread's deque, or -1 outside the pool. A thread
+// belongs to at most one JobSystem.
+static thread_local int workerIndex = -1;
+static thread_local const JobSystem* workerOwner = nullptr;
+
+WorkDeque::WorkDeque(int64_t capacity) {
+    rings.emplace_back(new Ring(capacity));
+    ring.store(rings.back().get(), std::memory_order_relaxed);
+}
+
+void WorkDeque::Push(Job* job) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Ring* r = ring.load(std::memory_order_relaxed);
+    if (b - t > r->capacity - 1) {
+        Ring* grown = new Ring(r->capacity * 2);
+        for (int64_t i = t; i < b; ++i) grown->Put(i, r->Get(i));
+        rings.emplace_back(grown);
+        ring.store(grown, std::memory_order_release);
+        r = grown;
+    }
+    r->Put(b, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+Job* WorkDeque::Pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Ring* r = ring.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = r->Get(b);
+    if (t == b) {
+        // Last item: race thieves for it.
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkDeque::Steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+    Ring* r = ring.load(std::memory_order_acquire);
+    Job* job = r->Get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+static size_t RoundUpPow2(size_t n) {
+    size_t p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+JobInjector::JobInjector(size_t capacity) {
+    size_t cap = RoundUpPow2(capacity);
+    cells.reset(new Cell[cap]);
+    mask = cap - 1;
+    for (size_t i = 0; i < cap; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool JobInjector::Push(Job* job) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells[pos & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.job = job;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+Job* JobInjector::Pop() {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells[pos & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                Job* job = cell.job;
+                cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                return job;
+            }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+JobSystem::JobSystem(int workerCount, size_t injectorCapacity) : injector(injectorCapacity) {
+    unsigned count = std::thread::hardware_concurrency();
+    if (count > 0) {
+        count--;
+    }
+    if (workerCount >= 0) {
+        count = static_cast<unsigned>(workerCount);
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        deques.emplace_back(new WorkDeque());
+    }
+    for (unsigned i = 0; i < count; ++i) {
+        workers.emplace_back([this, i]() { WorkerLoop(static_cast<int>(i)); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        parkCv.notify_all();
+    }
+    for (auto& w : workers) {
+        if (w.joinable()) w.join();
+    }
+    while (Job* job = injector.Pop()) delete job;
+    for (auto& d : deques) {
+        while (Job* job = d->Pop()) delete job;
+    }
+}
+
+void JobSystem::Submit(Job job) {
+    Job* heapJob = new Job(std::move(job));
+    unfinished.fetch_add(1, std::memory_order_relaxed);
+    queued.fetch_add(1, std::memory_order_seq_cst);
+    if (workerOwner == this && workerIndex >= 0) {
+        deques[workerIndex]->Push(heapJob);
+    } else {
+        while (!injector.Push(heapJob)) {
+            // Injector full: make room by running queued work here.
+            if (Job* other = injector.Pop()) Run(other);
+        }
+    }
+    if (sleeping.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        parkCv.notify_one();
+    }
+}
+
+Job* JobSystem::FindJob(int self) {
+    if (self >= 0) {
+        if (Job* job = deques[self]->Pop()) return job;
+    }
+    if (Job* job = injector.Pop()) return job;
+    int count = static_cast<int>(deques.size());
+    int start = (self >= 0) ? self + 1 : 0;
+    for (int i = 0; i < count; ++i) {
+        int victim = (start + i) % count;
+        if (victim == self) continue;
+        if (Job* job = deques[victim]->Steal()) return job;
+    }
+    return nullptr;
+}
+
+void JobSystem::Run(Job* job) {
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    (*job)();
+    delete job;
+    unfinished.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(int index) {
+    workerIndex = index;
+    workerOwner = this;
+    int idleSpins = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        if (Job* job = FindJob(index)) {
+            Run(job);
+            idleSpins = 0;
+            continue;
+        }
+        if (++idleSpins < 64) {
+            std::this_thread::yield();
+            continue;
+        }
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(parkMutex);
+            parkCv.wait(lock, [&] {
+                return queued.load(std::memory_order_seq_cst) > 0 || !running.load();
+            });
+        }
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+        idleSpins = 0;
+    }
+}
+
+void JobSystem::Wait() {
+    int self = (workerOwner == this) ? workerIndex : -1;
+    while (unfinished.load(std::memory_order_acquire) > 0) {
+        if (Job* job = FindJob(self)) {
+            Run(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+int JobSystem::WorkerCount() const {
+    return static_cast<int>(workers.size());
+}
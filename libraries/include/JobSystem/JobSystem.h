@@ -0,0 +1,136 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Job = std::function<void()>;
+
+// Chase-Lev work-stealing deque. Only the owning worker calls Push and Pop;
+// any thread may Steal. Grown arrays are kept until destruction so a thief
+// never reads freed memory.
+class WorkDeque {
+private:
+    struct Ring {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<Job*>[]> slots;
+        explicit Ring(int64_t cap) : capacity(cap), slots(new std::atomic<Job*>[cap]) {}
+        Job* Get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void Put(int64_t i, Job* job) { slots[i & (capacity - 1)].store(job, std::memory_order_relaxed); }
+    };
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Ring*> ring;
+    std::vector<std::unique_ptr<Ring>> rings;
+public:
+    explicit WorkDeque(int64_t capacity = 1024);
+    void Push(Job* job);
+    Job* Pop();
+    Job* Steal();
+};
+
+// Vyukov bounded multi-producer multi-consumer queue; used to hand jobs
+// from threads outside the pool to the workers.
+class JobInjector {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Job* job;
+    };
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+public:
+    explicit JobInjector(size_t capacity);
+    bool Push(Job* job);
+    Job* Pop();
+};
+
+// Vyukov intrusive multi-producer single-consumer queue. Any thread may
+// Push; only one thread may TryPop at a time.
+template <typename T>
+class MpscQueue {
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) Node* tail;
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head.store(stub, std::memory_order_relaxed);
+        tail = stub;
+    }
+    ~MpscQueue() {
+        while (tail) {
+            Node* next = tail->next.load(std::memory_order_relaxed);
+            delete tail;
+            tail = next;
+        }
+    }
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void Push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+    // Returns false when empty or when a producer is between its exchange
+    // and link; the item shows up on a later call.
+    bool TryPop(T& out) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        out = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+};
+
+// Fixed pool of workers, each with its own WorkDeque. Jobs submitted from a
+// worker go to that worker's deque; jobs from other threads go through a
+// shared JobInjector. Idle workers steal before parking on a condition
+// variable.
+class JobSystem {
+private:
+    std::vector<std::unique_ptr<WorkDeque>> deques;
+    JobInjector injector;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running{true};
+    std::atomic<int64_t> queued{0};
+    std::atomic<int64_t> unfinished{0};
+    std::atomic<int> sleeping{0};
+    std::mutex parkMutex;
+    std::condition_variable parkCv;
+
+    Job* FindJob(int self);
+    void Run(Job* job);
+    void WorkerLoop(int index);
+public:
+    // workerCount < 0 uses one worker per hardware thread minus one.
+    explicit JobSystem(int workerCount = -1, size_t injectorCapacity = 1 << 16);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void Submit(Job job);
+    // Blocks until every submitted job has run. The calling thread executes
+    // jobs while it waits, so this also works with zero workers. Must not be
+    // called from inside a job.
+    void Wait();
+    int WorkerCount() const;
+};
+
+#endif
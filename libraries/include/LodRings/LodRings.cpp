@@ -0,0 +1,183 @@
+#include "LodRings.h"
+#include <algorithm>
+
+bool LodBox::Empty() const {
+    return max.x <= min.x || max.y <= min.y || max.z <= min.z;
+}
+
+LodBox LodBox::Intersect(const LodBox& other) const {
+    LodBox box;
+    box.min = glm::max(min, other.min);
+    box.max = glm::min(max, other.max);
+    if (box.Empty()) return LodBox();
+    return box;
+}
+
+bool LodBox::Contains(glm::ivec3 block) const {
+    return block.x >= min.x && block.y >= min.y && block.z >= min.z
+        && block.x < max.x && block.y < max.y && block.z < max.z;
+}
+
+bool LodBox::operator==(const LodBox& other) const {
+    return min == other.min && max == other.max;
+}
+
+bool LodBox::operator!=(const LodBox& other) const {
+    return !(*this == other);
+}
+
+LodBox LodRings::EffectiveHole(int level, glm::ivec2 column, const Column& c, const LodBox& hole, int minChunkY, int maxChunkY) {
+    int lo = std::max(c.surfaceMinY, minChunkY);
+    int hi = std::min(c.surfaceMaxY, maxChunkY);
+    if (lo > hi) return LodBox();
+    // A mesh reads one cell past its chunk on every side.
+    int cell = 1 << level;
+    int span = CHUNK_SIZE * cell;
+    LodBox reach;
+    reach.min = glm::ivec3(column.x * span, lo * span, column.y * span) - cell;
+    reach.max = glm::ivec3((column.x + 1) * span, (hi + 1) * span, (column.y + 1) * span) + cell;
+    return hole.Intersect(reach);
+}
+
+void LodRings::EvictColumn(int level, glm::ivec2 column, const Column& c, std::vector<glm::ivec4>& evicted) {
+    for (int y : c.chunkYs) {
+        evicted.push_back(glm::ivec4(column.x, y, column.y, level));
+    }
+}
+
+void LodRings::Configure(int newLevels, int newRadius, std::vector<glm::ivec4>& evicted) {
+    for (int level = 1; level <= MaxLevel; ++level) {
+        for (const auto& p : columns[level]) EvictColumn(level, p.first, p.second, evicted);
+        columns[level].clear();
+    }
+    pending.clear();
+    levels = std::clamp(newLevels, 0, MaxLevel);
+    radius = std::clamp(newRadius, 1, MaxRadius);
+}
+
+void LodRings::Recenter(glm::ivec3 camera, glm::ivec3 baseRadius, std::vector<glm::ivec4>& evicted) {
+    cameraChunk = camera;
+    pending.clear();
+    if (levels == 0) return;
+    // Each ring must reach past the one inside it, whatever the camera's
+    // position within its own larger chunk.
+    int r = std::min(MaxRadius, std::max(radius, (std::max(baseRadius.x, baseRadius.z) + 1) / 2));
+    LodBox finer;
+    finer.min = (camera - baseRadius) * CHUNK_SIZE;
+    finer.max = (camera + baseRadius + 1) * CHUNK_SIZE;
+    for (int level = 1; level <= levels; ++level) {
+        int cell = 1 << level;
+        int span = CHUNK_SIZE * cell;
+        glm::ivec3 center(FloorDiv(camera.x, cell), FloorDiv(camera.y, cell), FloorDiv(camera.z, cell));
+        int minChunkY = center.y - MaxRadius;
+        int maxChunkY = center.y + MaxRadius;
+        auto& table = columns[level];
+        for (auto it = table.begin(); it != table.end();) {
+            glm::ivec2 delta = glm::abs(it->first - glm::ivec2(center.x, center.z));
+            if (std::max(delta.x, delta.y) > r) {
+                EvictColumn(level, it->first, it->second, evicted);
+                it = table.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (int dx = -r; dx <= r; ++dx) {
+            for (int dz = -r; dz <= r; ++dz) {
+                glm::ivec2 column(center.x + dx, center.z + dz);
+                Column& c = table[column];
+                bool stale;
+                if (c.ticket == 0) {
+                    stale = true;
+                } else if (c.surfaceKnown) {
+                    auto window = [&](int lo, int hi) {
+                        return glm::ivec2(std::max(c.surfaceMinY, lo), std::min(c.surfaceMaxY, hi));
+                    };
+                    glm::ivec2 before = window(c.minChunkY, c.maxChunkY);
+                    glm::ivec2 after = window(minChunkY, maxChunkY);
+                    bool sameWindow = (before == after) || (before.x > before.y && after.x > after.y);
+                    stale = !sameWindow
+                         || EffectiveHole(level, column, c, finer, minChunkY, maxChunkY) != EffectiveHole(level, column, c, c.hole, c.minChunkY, c.maxChunkY);
+                } else {
+                    stale = c.hole != finer || c.minChunkY != minChunkY || c.maxChunkY != maxChunkY;
+                }
+                if (stale) {
+                    c.ticket = nextTicket++;
+                    c.hole = finer;
+                    c.minChunkY = minChunkY;
+                    c.maxChunkY = maxChunkY;
+                    c.waiting = true;
+                }
+                if (c.waiting) pending.push_back(glm::ivec3(column.x, level, column.y));
+            }
+        }
+        finer.min = glm::ivec3(center.x - r, minChunkY, center.z - r) * span;
+        finer.max = glm::ivec3(center.x + r + 1, maxChunkY + 1, center.z + r + 1) * span;
+    }
+    glm::vec2 eye = glm::vec2(camera.x, camera.z) * static_cast<float>(CHUNK_SIZE);
+    auto distance = [&](glm::ivec3 p) {
+        float span = static_cast<float>(CHUNK_SIZE << p.y);
+        return glm::length((glm::vec2(p.x, p.z) + 0.5f) * span - eye);
+    };
+    std::sort(pending.begin(), pending.end(), [&](glm::ivec3 a, glm::ivec3 b) {
+        return distance(a) > distance(b);
+    });
+}
+
+size_t LodRings::TakeBuilds(size_t max, std::vector<LodBuild>& out) {
+    size_t taken = 0;
+    while (taken < max && !pending.empty()) {
+        glm::ivec3 p = pending.back();
+        pending.pop_back();
+        auto it = columns[p.y].find(glm::ivec2(p.x, p.z));
+        if (it == columns[p.y].end() || !it->second.waiting) continue;
+        Column& c = it->second;
+        c.waiting = false;
+        LodBuild build;
+        build.level = p.y;
+        build.column = it->first;
+        build.ticket = c.ticket;
+        build.hole = c.hole;
+        build.minChunkY = c.minChunkY;
+        build.maxChunkY = c.maxChunkY;
+        out.push_back(build);
+        ++taken;
+    }
+    return taken;
+}
+
+bool LodRings::Complete(const LodBuild& build, int surfaceMinY, int surfaceMaxY, const std::vector<int>& chunkYs,
+                        std::vector<glm::ivec4>& evicted) {
+    auto it = columns[build.level].find(build.column);
+    if (it == columns[build.level].end() || it->second.ticket != build.ticket) return false;
+    Column& c = it->second;
+    for (int y : c.chunkYs) {
+        if (std::find(chunkYs.begin(), chunkYs.end(), y) == chunkYs.end()) {
+            evicted.push_back(glm::ivec4(build.column.x, y, build.column.y, build.level));
+        }
+    }
+    c.chunkYs = chunkYs;
+    c.surfaceKnown = true;
+    c.surfaceMinY = surfaceMinY;
+    c.surfaceMaxY = surfaceMaxY;
+    return true;
+}
+
+int LodRings::Levels() const {
+    return levels;
+}
+
+size_t LodRings::PendingCount() const {
+    return pending.size();
+}
+
+size_t LodRings::ColumnCount(int level) const {
+    if (level < 1 || level > MaxLevel) return 0;
+    return columns[level].size();
+}
+
+size_t LodRings::MeshCount(int level) const {
+    if (level < 1 || level > MaxLevel) return 0;
+    size_t count = 0;
+    for (const auto& p : columns[level]) count += p.second.chunkYs.size();
+    return count;
+}
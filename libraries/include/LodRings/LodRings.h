@@ -0,0 +1,109 @@
+#ifndef LODRINGS_H
+#define LODRINGS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+#include "../Chunk/Chunk.h"
+
+// Division rounding towards negative infinity.
+inline int FloorDiv(int a, int b) {
+    int q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Box in block coordinates, max exclusive. Empty when any max <= min.
+struct LodBox {
+    glm::ivec3 min{0};
+    glm::ivec3 max{0};
+    bool Empty() const;
+    LodBox Intersect(const LodBox& other) const;
+    bool Contains(glm::ivec3 block) const;
+    bool operator==(const LodBox& other) const;
+    bool operator!=(const LodBox& other) const;
+};
+
+// A column of level-`level` chunks for a job to generate and mesh. A chunk
+// at level L spans CHUNK_SIZE cells of 2^L blocks each, and its coordinate
+// counts in those larger chunks.
+struct LodBuild {
+    int level = 0;
+    glm::ivec2 column{0};
+    uint32_t ticket = 0;
+    // Blocks drawn by finer levels. Cells inside are left empty, so the
+    // coarse mesh closes its side of the seam with walls.
+    LodBox hole;
+    // Chunk y range the column may mesh, inclusive. Keeps every chunk
+    // within PackVertex's wrap distance of the camera.
+    int minChunkY = 0;
+    int maxChunkY = -1;
+};
+
+// Which far terrain columns each LOD level should draw. Level 0 is the box
+// of full-resolution chunks ChunkManager loads. Each coarser level covers
+// the chunk columns within `radius` of the camera, minus the region the
+// level below it covers; levels L >= 1 are columns rather than cubes
+// because far terrain is only a thin band around the surface. A column is
+// rebuilt when the finer region or the vertical window moves across the
+// part of it holding terrain, and keeps its old meshes until then. Main
+// thread only.
+class LodRings {
+public:
+    static constexpr int MaxLevel = LOD_LEVELS - 1;
+    // Chunks further than this from the camera, in their own level's
+    // units, would alias in PackVertex's 6-bit wrapped coordinates.
+    static constexpr int MaxRadius = 30;
+private:
+    struct Column {
+        // Newest build handed out; results of older ones are dropped.
+        uint32_t ticket = 0;
+        LodBox hole;
+        int minChunkY = 0;
+        int maxChunkY = -1;
+        // Waiting in pending, not yet taken by a job.
+        bool waiting = false;
+        bool surfaceKnown = false;
+        int surfaceMinY = 0;
+        int surfaceMaxY = -1;
+        // Chunk ys whose meshes are out, from the last accepted build.
+        std::vector<int> chunkYs;
+    };
+    int levels = 0;
+    int radius = 0;
+    uint32_t nextTicket = 1;
+    glm::ivec3 cameraChunk{0};
+    std::array<std::unordered_map<glm::ivec2, Column>, LOD_LEVELS> columns;
+    // Columns waiting for a job, best candidate last.
+    std::vector<glm::ivec3> pending;
+
+    // Part of the hole and of the chunk y window that the column's terrain
+    // actually touches; the column's meshes depend on nothing else.
+    static LodBox EffectiveHole(int level, glm::ivec2 column, const Column& c, const LodBox& hole, int minChunkY, int maxChunkY);
+    static void EvictColumn(int level, glm::ivec2 column, const Column& c, std::vector<glm::ivec4>& evicted);
+public:
+    // levels coarse levels (0 disables LOD, at most MaxLevel), each
+    // covering `radius` chunks of its own size around the camera. Meshes
+    // already out are appended to evicted.
+    void Configure(int levels, int radius, std::vector<glm::ivec4>& evicted);
+    // Moves the rings to a new camera chunk. baseRadius is the per-axis
+    // radius of the box ChunkManager loads at full resolution.
+    void Recenter(glm::ivec3 cameraChunk, glm::ivec3 baseRadius, std::vector<glm::ivec4>& evicted);
+    // Hands out up to max waiting builds, nearest first.
+    size_t TakeBuilds(size_t max, std::vector<LodBuild>& out);
+    // Accepts a finished build unless a newer one superseded it. chunkYs
+    // lists the chunks the build produced meshes for; meshes of the
+    // column's previous build that are not among them are evicted.
+    bool Complete(const LodBuild& build, int surfaceMinY, int surfaceMaxY, const std::vector<int>& chunkYs,
+                  std::vector<glm::ivec4>& evicted);
+    int Levels() const;
+    size_t PendingCount() const;
+    size_t ColumnCount(int level) const;
+    size_t MeshCount(int level) const;
+};
+
+#endif
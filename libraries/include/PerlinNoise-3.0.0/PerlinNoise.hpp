@@ -32,6 +32,9 @@
 # include <numeric>
 # include <random>
 # include <type_traits>
+# ifdef __SSE4_1__
+# include <immintrin.h>
+# endif
 # if __has_include(<concepts>) && defined(__cpp_concepts)
 # include <concepts>
 # endif
@@ -182,7 +185,6 @@ using PerlinNoise = BasicPerlinNoise<float>;
 
 #ifdef __SSE4_1__
 // SIMD-optimized version for float (requires SSE4.1)
-# include <immintrin.h>
 
 template<class Float>
 class SimdPerlinNoise : public BasicPerlinNoise<Float>
@@ -0,0 +1,94 @@
+#include "StagingUploader.h"
+#include <algorithm>
+
+StagingUploader::StagingUploader(UploadBackend& backend, size_t capacity, size_t frameBudget)
+    : backend(backend), capacity(capacity), frameBudget(frameBudget) {
+}
+
+StagingUploader::~StagingUploader() {
+    for (const auto& batch : batches) backend.DeleteFence(batch.fence);
+}
+
+// Ring space is handed out in order, so the free region always starts at
+// head and runs, wrapping, up to the oldest in-flight batch.
+bool StagingUploader::Fits(size_t bytes, size_t& offset, size_t& padding) const {
+    if (bytes > capacity) return false;
+    if (head + bytes <= capacity) {
+        offset = head;
+        padding = 0;
+    } else {
+        offset = 0;
+        padding = capacity - head;
+    }
+    return used + padding + bytes <= capacity;
+}
+
+void StagingUploader::BeginFrame() {
+    while (!batches.empty() && backend.IsSignaled(batches.front().fence)) {
+        backend.DeleteFence(batches.front().fence);
+        used -= batches.front().bytes;
+        batches.pop_front();
+    }
+    if (used == 0) head = 0;
+}
+
+bool StagingUploader::CanUpload(size_t bytes) {
+    if (frameBytes > 0 && frameBytes + bytes > frameBudget) {
+        stats.budgetDeferrals++;
+        return false;
+    }
+    size_t offset, padding;
+    if (bytes <= capacity && !Fits(bytes, offset, padding)) {
+        stats.ringFullDeferrals++;
+        return false;
+    }
+    approved = bytes;
+    return true;
+}
+
+bool StagingUploader::Upload(UploadTarget target, size_t destOffset, const void* data, size_t bytes) {
+    if (bytes > approved && !CanUpload(bytes)) return false;
+    approved -= std::min(approved, bytes);
+    size_t offset, padding;
+    if (Fits(bytes, offset, padding)) {
+        backend.WriteStaging(offset, data, bytes);
+        backend.CopyStaging(target, offset, destOffset, bytes);
+        head = offset + bytes;
+        used += padding + bytes;
+        frameRingBytes += padding + bytes;
+    } else {
+        backend.WriteDirect(target, destOffset, data, bytes);
+        stats.directWrites++;
+    }
+    frameBytes += bytes;
+    stats.bytesUploaded += bytes;
+    stats.uploads++;
+    return true;
+}
+
+void StagingUploader::EndFrame() {
+    if (frameRingBytes > 0) {
+        batches.push_back({backend.InsertFence(), frameRingBytes});
+    }
+    stats.frames++;
+    stats.maxFrameBytes = std::max(stats.maxFrameBytes, frameBytes);
+    frameRingBytes = 0;
+    frameBytes = 0;
+    approved = 0;
+}
+
+void StagingUploader::SetFrameBudget(size_t bytes) {
+    frameBudget = bytes;
+}
+
+size_t StagingUploader::FrameBudget() const {
+    return frameBudget;
+}
+
+size_t StagingUploader::InFlightBytes() const {
+    return used;
+}
+
+UploadStats StagingUploader::Stats() const {
+    return stats;
+}
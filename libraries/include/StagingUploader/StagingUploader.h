@@ -0,0 +1,92 @@
+#ifndef STAGING_UPLOADER_H
+#define STAGING_UPLOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+enum class UploadTarget {
+    Vertices,
+    Indices
+};
+
+// What StagingUploader needs from the graphics API. Offsets and sizes are
+// in bytes. The GL implementation lives with ChunkMeshRegistry; the bench
+// drives the uploader headlessly through a mock.
+class UploadBackend {
+public:
+    virtual ~UploadBackend() = default;
+    // Fills a staging range the GPU is no longer reading.
+    virtual void WriteStaging(size_t offset, const void* data, size_t bytes) = 0;
+    // Queues a GPU-side copy from staging into the target buffer.
+    virtual void CopyStaging(UploadTarget target, size_t stagingOffset, size_t destOffset, size_t bytes) = 0;
+    // Writes straight into the target; only used for uploads larger than
+    // the whole staging ring.
+    virtual void WriteDirect(UploadTarget target, size_t destOffset, const void* data, size_t bytes) = 0;
+    // Fences every command queued so far.
+    virtual uint64_t InsertFence() = 0;
+    virtual bool IsSignaled(uint64_t fence) = 0;
+    virtual void DeleteFence(uint64_t fence) = 0;
+};
+
+struct UploadStats {
+    size_t bytesUploaded = 0;
+    size_t uploads = 0;
+    size_t frames = 0;
+    size_t maxFrameBytes = 0;
+    // Upload requests refused by the frame budget or by a full ring.
+    size_t budgetDeferrals = 0;
+    size_t ringFullDeferrals = 0;
+    size_t directWrites = 0;
+};
+
+// Streams uploads through a fixed staging ring. Each frame's writes are
+// fenced together; ring space is reused only once the GPU has passed that
+// fence, so staging writes never wait on the GPU. A per-frame byte budget
+// spreads a burst of finished meshes over several frames instead of
+// stalling one.
+class StagingUploader {
+private:
+    struct Batch {
+        uint64_t fence;
+        // Ring bytes the batch holds, including padding skipped at a wrap.
+        size_t bytes;
+    };
+    UploadBackend& backend;
+    size_t capacity;
+    size_t frameBudget;
+    size_t head = 0;
+    size_t used = 0;
+    size_t frameRingBytes = 0;
+    size_t frameBytes = 0;
+    // Bytes cleared by the last CanUpload, which Upload calls may consume
+    // without re-checking.
+    size_t approved = 0;
+    std::deque<Batch> batches;
+    UploadStats stats;
+
+    bool Fits(size_t bytes, size_t& offset, size_t& padding) const;
+public:
+    StagingUploader(UploadBackend& backend, size_t capacity, size_t frameBudget);
+    ~StagingUploader();
+    StagingUploader(const StagingUploader&) = delete;
+    StagingUploader& operator=(const StagingUploader&) = delete;
+
+    // Releases ring space behind fences the GPU has passed.
+    void BeginFrame();
+    // Whether an upload of this many bytes, possibly split into several
+    // Upload calls, is accepted this frame. The first upload of a frame is
+    // always within budget so oversized meshes still make progress.
+    bool CanUpload(size_t bytes);
+    // False, with nothing written, when CanUpload(bytes) is false.
+    bool Upload(UploadTarget target, size_t destOffset, const void* data, size_t bytes);
+    // Fences this frame's copies.
+    void EndFrame();
+
+    void SetFrameBudget(size_t bytes);
+    size_t FrameBudget() const;
+    size_t InFlightBytes() const;
+    UploadStats Stats() const;
+};
+
+#endif
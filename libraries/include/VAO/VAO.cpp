@@ -34,6 +34,20 @@ void VAO::LinkIntVbo(VBO& vbo, GLuint index, GLint components, GLsizei strideFlo
     vbo.Unbind();
 }
 
+void VAO::LinkUIntVbo(VBO& vbo, GLuint index, GLint components, GLsizei strideUInts, void* offset)
+{
+    vbo.Bind();
+    glVertexAttribIPointer(
+        index, 
+        components, 
+        GL_UNSIGNED_INT, 
+        strideUInts * sizeof(GLuint), 
+        offset
+    );
+    glEnableVertexAttribArray(index);
+    vbo.Unbind();
+}
+
 void VAO::Refresh(){
     glGenVertexArrays(1, &ID);
 }
@@ -12,6 +12,7 @@ public:
     VAO();
     void LinkFloatVbo(VBO& vbo, GLuint index, GLint components, GLsizei strideFloats, void* offset);
     void LinkIntVbo(VBO& vbo, GLuint index, GLint components, GLsizei strideFloats, void* offset);
+    void LinkUIntVbo(VBO& vbo, GLuint index, GLint components, GLsizei strideUInts, void* offset);
 
     void Refresh();
     void Bind();
@@ -7,7 +7,7 @@
 VBO::VBO() : ID(0){
 }
 
-void VBO::Refresh(Vertex* vertices, GLsizeiptr size, GLuint usage) {
+void VBO::Refresh(PackedVertex const * vertices, GLsizeiptr size, GLuint usage) {
     if (ID != 0) Delete();  
     glGenBuffers(1, &ID);
     glBindBuffer(GL_ARRAY_BUFFER, ID);
@@ -29,6 +29,17 @@ void VBO::Refresh(GLfloat const * vertices, GLsizeiptr size, GLuint usage) {
     glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
 }
 
+void VBO::Allocate(GLsizeiptr size, GLuint usage) {
+    if (ID != 0) Delete();
+    glGenBuffers(1, &ID);
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage);
+}
+
+void VBO::SubData(GLintptr offset, GLsizeiptr size, const void* data) {
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
 
 
 VBO::VBO(GLfloat* vertices , GLsizeiptr size , GLuint usage){
@@ -43,7 +54,7 @@ VBO::VBO(GLint* vertices , GLsizeiptr size , GLuint usage){
     glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
 }
 
-VBO::VBO(Vertex* vertices , GLsizeiptr size , GLuint usage){
+VBO::VBO(PackedVertex* vertices , GLsizeiptr size , GLuint usage){
     glGenBuffers(1, &ID);
     glBindBuffer(GL_ARRAY_BUFFER, ID);
     glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
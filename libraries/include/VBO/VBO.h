@@ -2,14 +2,49 @@
 #define VBO_H
 
 #include <glm/ext/vector_int3.hpp>
-#define GLFW_INCLUDE_NONE
 #include "../glad/glad.h"
-#include <GLFW/glfw3.h>
 #include "glm/glm.hpp"
 
-struct Vertex{
-    glm::ivec3 Position;
-    glm::ivec3 Normal;
+// Chunk mesh vertex packed into 8 bytes.
+// Data0: chunk-local corner x/y/z (6 bits each), face id (3 bits), block id (8 bits).
+// Data1: quad width/height (6 bits each), owning chunk coordinate wrapped to
+// 6 bits per axis, LOD level (2 bits). default.vert rebuilds the chunk
+// origin relative to the camera chunk, which is unambiguous while every
+// resident chunk lies within 31 chunks of the camera. At LOD level L,
+// positions and sizes count in cells of 2^L blocks and the chunk
+// coordinate is in chunks of that size, relative to the camera chunk
+// shifted right by L.
+struct PackedVertex{
+    GLuint Data0;
+    GLuint Data1;
+};
+
+inline PackedVertex PackVertex(glm::ivec3 localPos, int face, int blockId, int width, int height, glm::ivec3 chunkCoord, int lod = 0){
+    PackedVertex v;
+    v.Data0 = (static_cast<GLuint>(localPos.x) & 63u)
+            | ((static_cast<GLuint>(localPos.y) & 63u) << 6)
+            | ((static_cast<GLuint>(localPos.z) & 63u) << 12)
+            | ((static_cast<GLuint>(face) & 7u) << 18)
+            | ((static_cast<GLuint>(blockId) & 255u) << 21);
+    v.Data1 = (static_cast<GLuint>(width) & 63u)
+            | ((static_cast<GLuint>(height) & 63u) << 6)
+            | ((static_cast<GLuint>(chunkCoord.x) & 63u) << 12)
+            | ((static_cast<GLuint>(chunkCoord.y) & 63u) << 18)
+            | ((static_cast<GLuint>(chunkCoord.z) & 63u) << 24)
+            | ((static_cast<GLuint>(lod) & 3u) << 30);
+    return v;
+}
+
+// One greedy quad for vertex pulling: PackVertex's layout with the quad's
+// first corner as position.
+using PackedQuad = PackedVertex;
+
+// Same layout as DrawArraysIndirectCommand.
+struct DrawArraysCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint first;
+    GLuint baseInstance;
 };
 
 
@@ -19,11 +54,13 @@ public:
     VBO();
     VBO(GLfloat* vertices , GLsizeiptr size , GLuint usage);
     explicit VBO(GLint* vertices , GLsizeiptr size , GLuint usage);
-    explicit VBO(Vertex* vertices , GLsizeiptr size , GLuint usage);
+    explicit VBO(PackedVertex* vertices , GLsizeiptr size , GLuint usage);
 
-    void Refresh(Vertex* vertices , GLsizeiptr size , GLuint usage);
+    void Refresh(PackedVertex const * vertices , GLsizeiptr size , GLuint usage);
     void Refresh(GLint const * vertices , GLsizeiptr size , GLuint usage);
     void Refresh(GLfloat const * vertices , GLsizeiptr size , GLuint usage);
+    void Allocate(GLsizeiptr size , GLuint usage);
+    void SubData(GLintptr offset , GLsizeiptr size , const void* data);
 
 
     void Bind();
@@ -4,108 +4,300 @@
 #include <mutex>
 #include <thread>
 #include <cmath>
+#include <climits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-World::World() : m_noise(12345u), running(true) {
-    heightCache.reserve(10000);  
-    unsigned num_threads = std::thread::hardware_concurrency();
-    if (num_threads > 0) {
-        num_threads--;
-    }
-    for (size_t i = 0; i < num_threads; ++i) {
-        workers.emplace_back([this]() {
-            std::vector<Vertex> vertices;
-            std::vector<GLuint> indices;
-            vertices.reserve(16384);  
-            indices.reserve(24576);   
-            while (running) {
-                glm::ivec3 ChunkCoord;
-                {
-                    std::unique_lock<std::mutex> workerLock(workerMutex);
-                    cv.wait(workerLock, [&] { return !ChunksToGenerate.empty() || !running; });
-                    if (!running) break;
-                    ChunkCoord = ChunksToGenerate.front();
-                    ChunksToGenerate.pop();
-                }
-                Chunk chunk;
-                chunk.initToAir();
-                setBlocks(ChunkCoord, chunk);
-                generateChunkMesh(ChunkCoord, chunk, vertices, indices);
-                {
-                    std::unique_lock<std::mutex> resultLock(resultMutex);
-                    generatedMeshes[ChunkCoord] = {std::move(ChunkCoord), std::move(vertices), std::move(indices)};
-                }
-                vertices.clear();
-                indices.clear();
-            }
-        });
+World::World(MeshFormat format, int workerCount) : meshFormat(format), m_noise(12345u), heightNoise(m_noise), jobs(workerCount) {
+    maxChunksInFlight = std::max(4, 4 * jobs.WorkerCount());
+}
+
+static uint64_t PackChunkCoord(glm::ivec3 c) {
+    constexpr uint64_t mask = (1ull << 21) - 1;
+    return (static_cast<uint64_t>(c.x) & mask)
+         | ((static_cast<uint64_t>(c.y) & mask) << 21)
+         | ((static_cast<uint64_t>(c.z) & mask) << 42);
+}
+
+static glm::ivec3 UnpackChunkCoord(uint64_t packed) {
+    auto field = [&](int shift) {
+        int v = static_cast<int>((packed >> shift) & ((1ull << 21) - 1));
+        return (v ^ (1 << 20)) - (1 << 20);
+    };
+    return glm::ivec3(field(0), field(21), field(42));
+}
+
+// Whether a chunk offset from the camera chunk lies in the region's shape.
+static bool InRegionShape(RegionShape shape, glm::ivec3 offset, int radius, int verticalRadius, bool squareFootprint) {
+    if (std::abs(offset.y) > verticalRadius) return false;
+    int horizontal = offset.x * offset.x + offset.z * offset.z;
+    if (squareFootprint) return std::max(std::abs(offset.x), std::abs(offset.z)) <= radius;
+    if (shape == RegionShape::Ellipsoid && verticalRadius > 0) {
+        // horizontal / r^2 + y^2 / v^2 <= 1, in integers.
+        int64_t r2 = static_cast<int64_t>(radius) * radius;
+        int64_t v2 = static_cast<int64_t>(verticalRadius) * verticalRadius;
+        return horizontal * v2 + static_cast<int64_t>(offset.y) * offset.y * r2 <= r2 * v2;
     }
+    return horizontal <= radius * radius;
 }
 
-void World::MergeChunks() {
-    GlobalVertices.clear();
-    GlobalIndices.clear();
-    {
-        std::unique_lock<std::mutex> lock(resultMutex);
-        GLuint offset = 0;
-        for (const auto& p : generatedMeshes) {
-            const auto& res = p.second;
-            GLuint currOffset = static_cast<GLuint>(GlobalVertices.size());
-            for (GLuint idx : res.indices) {
-                GlobalIndices.push_back(idx + currOffset);
-            }
-            GlobalVertices.insert(GlobalVertices.end(), res.vertices.begin(), res.vertices.end());
-            offset += static_cast<GLuint>(res.vertices.size());
+// Same shape test as ChunkManager's. The terrain band is left out: it
+// depends only on the column, so a chunk that was inside it when queued
+// still is.
+bool World::isStale(glm::ivec3 chunkCoord, uint32_t ticket) const {
+    if (!staleChecks.load(std::memory_order_relaxed)) return false;
+    // Same epoch means the camera has not changed chunk since submission.
+    if (ticket == epoch.load(std::memory_order_acquire)) return false;
+    glm::ivec3 camera = UnpackChunkCoord(cameraChunk.load(std::memory_order_relaxed));
+    return !InRegionShape(activeShape.load(std::memory_order_relaxed), chunkCoord - camera,
+                          activeRadius.load(std::memory_order_relaxed),
+                          activeVerticalRadius.load(std::memory_order_relaxed),
+                          activeSquareFootprint.load(std::memory_order_relaxed));
+}
+
+namespace {
+struct InFlightGuard {
+    std::atomic<int>& count;
+    ~InFlightGuard() { count.fetch_sub(1, std::memory_order_relaxed); }
+};
+}
+
+void World::buildChunk(glm::ivec3 chunkCoord, uint32_t ticket) {
+    InFlightGuard guard{chunksInFlight};
+    if (!chunkStates.Transition(chunkCoord, ChunkState::Queued, ChunkState::Generating)) {
+        workStats.cancelled.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (isStale(chunkCoord, ticket)) {
+        chunkStates.Remove(chunkCoord, ChunkState::Generating);
+        workStats.cancelled.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    auto chunk = std::make_shared<Chunk>();
+    chunk->initToAir();
+    setBlocks(chunkCoord, *chunk);
+    workStats.generations.fetch_add(1, std::memory_order_relaxed);
+    // The store's window may have moved past the chunk since the last check.
+    if (isStale(chunkCoord, ticket) || !chunks.Put(chunkCoord, chunk)
+        || !chunkStates.Transition(chunkCoord, ChunkState::Generating, ChunkState::Generated)) {
+        chunks.Erase(chunkCoord, chunk);
+        chunkStates.Remove(chunkCoord, ChunkState::Generating);
+        workStats.wastedGenerations.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    WorkResult mesh;
+    mesh.coord = chunkCoord;
+    generateChunkMesh(chunkCoord, *chunk, mesh);
+    if (isStale(chunkCoord, ticket) || !chunkStates.Transition(chunkCoord, ChunkState::Generated, ChunkState::Meshed)) {
+        // Take the chunk back out, or the next scan would queue it again
+        // while this undelivered copy is still visible to its neighbours.
+        chunks.Erase(chunkCoord, chunk);
+        chunkStates.Remove(chunkCoord, ChunkState::Generated);
+        workStats.wastedMeshes.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint8_t mask = mesh.neighborMask;
+    chunkStates.UpdateNeighborMask(chunkCoord, mask);
+    completedMeshes.Push(std::move(mesh));
+    requestRemeshes(chunkCoord, *chunk, mask, true);
+}
+
+// A neighbour and this chunk only hide each other's faces if both border
+// layers facing each other have solid blocks.
+static bool BordersTouch(const Chunk& chunk, const Chunk& neighbor, int d) {
+    int axis = d / 2;
+    bool isPos = (d % 2 == 0);
+    return chunk.layerHasSolid(axis, isPos ? CHUNK_SIZE - 1 : 0)
+        && neighbor.layerHasSolid(axis, isPos ? 0 : CHUNK_SIZE - 1);
+}
+
+void World::requestRemeshes(glm::ivec3 chunkCoord, const Chunk& chunk, uint8_t ownMask, bool includeNeighbors) {
+    // Either this job or the neighbour's sees the other: each publishes its
+    // mask before checking, so a pair meshed concurrently is never missed.
+    bool remeshSelf = false;
+    for (int d = 0; d < 6; ++d) {
+        glm::ivec3 neighC = chunkCoord;
+        neighC[d / 2] += (d % 2 == 0) ? 1 : -1;
+        ChunkRef neighbor = chunks.Get(neighC);
+        if (!neighbor || !BordersTouch(chunk, *neighbor, d)) continue;
+        if (!(ownMask & (1u << d))) remeshSelf = true;
+        uint8_t neighborMask;
+        if (includeNeighbors && chunkStates.GetNeighborMask(neighC, neighborMask) && !(neighborMask & (1u << (d ^ 1)))) {
+            jobs.Submit([this, neighC]() { remeshChunk(neighC); });
         }
     }
+    if (remeshSelf) {
+        jobs.Submit([this, chunkCoord]() { remeshChunk(chunkCoord); });
+    }
 }
 
-void World::setBlocks(glm::ivec3 chunkCoord, Chunk& currentChunk) {
+void World::remeshChunk(glm::ivec3 chunkCoord) {
+    ChunkRef chunk = chunks.Get(chunkCoord);
+    ChunkState state;
+    if (!chunk || !chunkStates.Get(chunkCoord, state)) return;
+    if (state != ChunkState::Meshed && state != ChunkState::Uploaded) return;
+    WorkResult mesh;
+    mesh.coord = chunkCoord;
+    generateChunkMesh(chunkCoord, *chunk, mesh);
+    uint8_t mask = mesh.neighborMask;
+    if (!chunkStates.UpdateNeighborMask(chunkCoord, mask)) return;
+    workStats.remeshes.fetch_add(1, std::memory_order_relaxed);
+    completedMeshes.Push(std::move(mesh));
+    requestRemeshes(chunkCoord, *chunk, mask, false);
+}
+
+void World::drainCompletedMeshes() {
+    WorkResult mesh;
+    while (completedMeshes.TryPop(mesh)) {
+        glm::ivec3 coord = mesh.coord;
+        // Unloaded while the result sat in the queue.
+        ChunkState state;
+        if (!chunkStates.Get(coord, state)) continue;
+        if (state != ChunkState::Meshed && state != ChunkState::Uploaded) continue;
+        // A remesh that saw fewer neighbours than the mesh we already have
+        // finished late.
+        auto it = generatedMeshes.find(coord);
+        if (it != generatedMeshes.end() && (mesh.neighborMask & it->second.neighborMask) != it->second.neighborMask) continue;
+        if (state == ChunkState::Uploaded) {
+            chunkStates.Transition(coord, ChunkState::Uploaded, ChunkState::Meshed);
+        }
+        acceptMesh(std::move(mesh));
+    }
+}
+
+void World::acceptMesh(WorkResult mesh) {
+    glm::ivec3 coord = mesh.coord;
+    generatedMeshes[coord].neighborMask = mesh.neighborMask;
+    if (keepMeshCopies) meshCopies[coord] = mesh;
+    finishedMeshes[coord] = std::move(mesh);
+}
+
+void World::columnHeights(glm::ivec2 chunkColumn, ColumnHeights& heights) const {
+    sampleHeights(chunkColumn * CHUNK_SIZE, 1, glm::ivec2(CHUNK_SIZE), heights.data());
+}
+
+void World::sampleHeights(glm::ivec2 origin, int stride, glm::ivec2 size, int* heights) const {
     constexpr float scale = 0.00008f;
     constexpr int octaves = 7;
     constexpr float persistence = 0.8f;
     constexpr float baseHeight = 32.0f;
     constexpr float heightAmp = 400.0f;
-    for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
-        for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
-            int globalX = chunkCoord.x * CHUNK_SIZE + lx;
-            int globalZ = chunkCoord.z * CHUNK_SIZE + lz;
-            glm::ivec2 key(globalX, globalZ);  
-            int terrainHeight;
-            {
-                std::unique_lock<std::mutex> lock(heightCacheMutex);  
-                auto it = heightCache.find(key);
-                if (it == heightCache.end()) {
-                    float globalXf = static_cast<float>(globalX);
-                    float globalZf = static_cast<float>(globalZ);
-                    float rawNoise = m_noise.octave2D(globalXf * scale, globalZf * scale, octaves, persistence);
-                    float noiseVal = (rawNoise + 1.0f) / 2.0f;
-                    float terrainHeightFloat = baseHeight + (noiseVal - 0.5f) * heightAmp * 2.0f;
-                    terrainHeight = static_cast<int>(std::floor(terrainHeightFloat));
-                    heightCache[key] = terrainHeight;  
-                } else {
-                    terrainHeight = it->second;
+    // Large grids go through the noise in batches so the scratch arrays
+    // stay on the stack.
+    constexpr int maxCount = PaddedChunk::PS * PaddedChunk::PS;
+    float xs[maxCount];
+    float zs[maxCount];
+    float noise[maxCount];
+    int total = size.x * size.y;
+    for (int first = 0; first < total; first += maxCount) {
+        int count = std::min(maxCount, total - first);
+        for (int i = 0; i < count; ++i) {
+            int lx = (first + i) % size.x;
+            int lz = (first + i) / size.x;
+            xs[i] = static_cast<float>(origin.x + lx * stride) * scale;
+            zs[i] = static_cast<float>(origin.y + lz * stride) * scale;
+        }
+        heightNoise.Octave2D(xs, zs, noise, count, octaves, persistence);
+        for (int i = 0; i < count; ++i) {
+            float noiseVal = (noise[i] + 1.0f) / 2.0f;
+            float terrainHeightFloat = baseHeight + (noiseVal - 0.5f) * heightAmp * 2.0f;
+            heights[first + i] = static_cast<int>(std::floor(terrainHeightFloat));
+        }
+    }
+}
+
+// Generates and meshes the chunks of one far terrain column straight from
+// heights sampled once per cell, without storing any blocks. A cell is
+// solid when its centre is below the terrain, so each level rounds the
+// surface to its own cell size; at level 0 this is setBlocks' rule. The
+// padded border comes from the same heights rather than from neighbouring
+// chunks, so columns never wait on or remesh for each other.
+void World::buildLodColumn(const LodBuild& build) {
+    InFlightGuard guard{chunksInFlight};
+    constexpr int PS = PaddedChunk::PS;
+    const int cell = 1 << build.level;
+    const int span = CHUNK_SIZE * cell;
+    glm::ivec2 origin = build.column * span - cell;
+    int heights[PS * PS];
+    sampleHeights(origin, cell, glm::ivec2(PS), heights);
+    int minHeight = *std::min_element(heights, heights + PS * PS);
+    int maxHeight = *std::max_element(heights, heights + PS * PS);
+
+    LodColumnResult result;
+    result.build = build;
+    // Chunks outside this range are solid or empty all the way through,
+    // padding included, so they cannot have faces.
+    result.surfaceMinY = FloorDiv(minHeight - 2 * cell, span);
+    result.surfaceMaxY = FloorDiv(maxHeight + cell, span);
+    int lo = std::max(result.surfaceMinY, build.minChunkY);
+    int hi = std::min(result.surfaceMaxY, build.maxChunkY);
+    PaddedChunk padded;
+    for (int cy = lo; cy <= hi; ++cy) {
+        glm::ivec3 chunkCoord(build.column.x, cy, build.column.y);
+        glm::ivec3 base = chunkCoord * span;
+        LodBox reach;
+        reach.min = base - cell;
+        reach.max = base + span + cell;
+        bool carved = !build.hole.Intersect(reach).Empty();
+        for (int z = -1; z <= CHUNK_SIZE; ++z) {
+            for (int y = -1; y <= CHUNK_SIZE; ++y) {
+                int blockY = base.y + y * cell;
+                for (int x = -1; x <= CHUNK_SIZE; ++x) {
+                    bool solid = blockY + cell / 2 < heights[(x + 1) + (z + 1) * PS];
+                    // Finer levels draw the hole; leaving it empty makes this
+                    // mesh wall off its side of the seam.
+                    if (solid && carved && build.hole.Contains(base + glm::ivec3(x, y, z) * cell)) solid = false;
+                    padded.blocks[PaddedChunk::Index(x, y, z)] = solid ? BlockType::SOLID : BlockType::AIR;
                 }
             }
-            for (int ly = 0; ly < CHUNK_SIZE; ++ly) {
-                int globalY = chunkCoord.y * CHUNK_SIZE + ly;
-                currentChunk.get(lx, ly, lz) = (globalY < terrainHeight) ? BlockType::SOLID : BlockType::AIR;
-            }
         }
+        WorkResult mesh;
+        mesh.coord = chunkCoord;
+        mesh.lod = build.level;
+        binaryMeshChunk(chunkCoord, padded, mesh);
+        if (!mesh.quads.empty() || !mesh.indices.empty()) result.meshes.push_back(std::move(mesh));
     }
-    {
-        std::unique_lock<std::mutex> ChunkMapLock(ChunkMapMutex);
-        chunks[chunkCoord] = currentChunk;
+    completedLodColumns.Push(std::move(result));
+}
+
+void World::setBlocks(glm::ivec3 chunkCoord, Chunk& currentChunk) {
+    glm::ivec2 column(chunkCoord.x, chunkCoord.z);
+    ColumnHeights heights;
+    if (!heightmaps.Get(column, heights)) {
+        // Jobs racing on the same column compute identical heights, so it
+        // does not matter whose Put lands.
+        columnHeights(column, heights);
+        heightmaps.Put(column, heights);
+    }
+    int minHeight = *std::min_element(heights.begin(), heights.end());
+    int maxHeight = *std::max_element(heights.begin(), heights.end());
+    int chunkMinY = chunkCoord.y * CHUNK_SIZE;
+    int chunkMaxY = chunkMinY + CHUNK_SIZE - 1;
+    if (uniformShortcut && chunkMinY >= maxHeight) {
+        currentChunk.fill(BlockType::AIR);
+    } else if (uniformShortcut && chunkMaxY < minHeight) {
+        currentChunk.fill(BlockType::SOLID);
+    } else {
+        std::array<BlockType, Chunk::VOLUME> dense;
+        for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+            for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+                for (int ly = 0; ly < CHUNK_SIZE; ++ly) {
+                    int globalY = chunkMinY + ly;
+                    dense[lx + ly * Chunk::CS + lz * Chunk::CS_SQR] = (globalY < heights[lx + lz * CHUNK_SIZE]) ? BlockType::SOLID : BlockType::AIR;
+                }
+            }
+        }
+        currentChunk.assign(dense);
     }
 }
 
-void World::emitFace(direction dir, glm::ivec3 localCoordinates, glm::ivec3 globalOffset, std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
+void World::emitFace(direction dir, glm::ivec3 localCoordinates, glm::ivec3 chunkCoord, std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices) {
     size_t directionIndex = static_cast<size_t>(dir);
     u_int32_t start = static_cast<u_int32_t>(vertices.size());
     for (int i = 0; i < 4; ++i) {
-        Vertex v;
-        v.Position = facePos[directionIndex][i] + glm::vec3(localCoordinates) + glm::vec3(globalOffset);
-        v.Normal = FaceNormal[directionIndex];
-        vertices.push_back(v);
+        glm::ivec3 corner = glm::ivec3(facePos[directionIndex][i]) + localCoordinates;
+        vertices.push_back(PackVertex(corner, static_cast<int>(dir), static_cast<int>(BlockType::SOLID), 1, 1, chunkCoord));
     }
     indices.push_back(start + 0);
     indices.push_back(start + 1);
@@ -115,8 +307,10 @@ void World::emitFace(direction dir, glm::ivec3 localCoordinates, glm::ivec3 glob
     indices.push_back(start + 0);
 }
 
-void World::emitGreedyFace(glm::ivec3 localMinCorner, direction dir, int height, int width, glm::ivec3 globalOffset, std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
+void World::emitGreedyFace(glm::ivec3 localMinCorner, direction dir, int height, int width, glm::ivec3 chunkCoord, WorkResult& mesh) {
     if (height <= 0 || width <= 0) return;
+    std::vector<PackedVertex>& vertices = mesh.vertices;
+    std::vector<GLuint>& indices = mesh.indices;
     GLuint start = static_cast<GLuint>(vertices.size());
     glm::vec3 n = FaceNormal[static_cast<int>(dir)];
     int fa = static_cast<int>(dir) / 2;
@@ -168,7 +362,6 @@ void World::emitGreedyFace(glm::ivec3 localMinCorner, direction dir, int height,
     } else {
         pos0 = glm::vec3(static_cast<float>(minv1), static_cast<float>(minv2), static_cast<float>(fixed_val));
     }
-    pos0 += glm::vec3(globalOffset);
     glm::vec3 p0 = pos0;
     glm::vec3 p1 = pos0;
     if (v2_axis == 0) p1.x += static_cast<float>(width);
@@ -182,14 +375,16 @@ void World::emitGreedyFace(glm::ivec3 localMinCorner, direction dir, int height,
     if (v2_axis == 0) p3.x += static_cast<float>(width);
     else if (v2_axis == 1) p3.y += static_cast<float>(width);
     else p3.z += static_cast<float>(width);
-    std::array<Vertex, 4> vs;
-    vs[0].Position = p0; vs[0].Normal = n;
-    vs[1].Position = p1; vs[1].Normal = n;
-    vs[2].Position = p2; vs[2].Normal = n;
-    vs[3].Position = p3; vs[3].Normal = n;
-    for (const auto& v : vs) {
-        vertices.push_back(v);
+    int face = static_cast<int>(dir);
+    int blockId = static_cast<int>(BlockType::SOLID);
+    if (meshFormat == MeshFormat::PulledQuads) {
+        mesh.quads.push_back(PackVertex(glm::ivec3(p0), face, blockId, width, height, chunkCoord, mesh.lod));
+        return;
     }
+    vertices.push_back(PackVertex(glm::ivec3(p0), face, blockId, width, height, chunkCoord, mesh.lod));
+    vertices.push_back(PackVertex(glm::ivec3(p1), face, blockId, width, height, chunkCoord, mesh.lod));
+    vertices.push_back(PackVertex(glm::ivec3(p2), face, blockId, width, height, chunkCoord, mesh.lod));
+    vertices.push_back(PackVertex(glm::ivec3(p3), face, blockId, width, height, chunkCoord, mesh.lod));
     if (!flip_winding) {
         indices.push_back(start + 0); indices.push_back(start + 2); indices.push_back(start + 1);
         indices.push_back(start + 2); indices.push_back(start + 3); indices.push_back(start + 1);
@@ -200,44 +395,25 @@ void World::emitGreedyFace(glm::ivec3 localMinCorner, direction dir, int height,
 }
 
 
-void World::greedyMeshSlice(const Chunk& current, const Chunk* neighbor, int fixed, direction dir, int localNeighCoord, i_vec3 globalOffset, std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
-    bool mask[CHUNK_SIZE][CHUNK_SIZE];  
-    std::fill_n(reinterpret_cast<bool*>(mask), CHUNK_SIZE * CHUNK_SIZE, false);
-    int sizeA, sizeB, blockX, blockY, blockZ, neighX, neighY, neighZ;
+void World::greedyMeshSlice(const PaddedChunk& padded, int fixed, direction dir, i_vec3 chunkCoord, WorkResult& mesh) {
+    bool mask[CHUNK_SIZE][CHUNK_SIZE];
+    int sizeA = CHUNK_SIZE, sizeB = CHUNK_SIZE;
     int axis = static_cast<int>(dir) / 2;
-    bool isPos = (static_cast<int>(dir) % 2 == 0);
-    if (axis == 0) {  
-        sizeA = CHUNK_SIZE; sizeB = CHUNK_SIZE;  
-        blockX = fixed; blockY = 0; blockZ = 0;
-        neighX = isPos ? localNeighCoord : localNeighCoord; neighY = 0; neighZ = 0;
-    } else if (axis == 1) {  
-        sizeA = CHUNK_SIZE; sizeB = CHUNK_SIZE;  
-        blockX = 0; blockY = fixed; blockZ = 0;
-        neighX = 0; neighY = isPos ? localNeighCoord : localNeighCoord; neighZ = 0;
-    } else {  
-        sizeA = CHUNK_SIZE; sizeB = CHUNK_SIZE;  
-        blockX = 0; blockY = 0; blockZ = fixed;
-        neighX = 0; neighY = 0; neighZ = isPos ? localNeighCoord : localNeighCoord;
-    }
-    
+    int step = (static_cast<int>(dir) % 2 == 0) ? 1 : -1;
+    int adjacent = fixed + step;
     for (int a = 0; a < sizeA; ++a) {
         for (int b = 0; b < sizeB; ++b) {
-            int lx = (axis == 0) ? fixed : ((axis == 1) ? a : a);
+            int lx = (axis == 0) ? fixed : a;
             int ly = (axis == 1) ? fixed : ((axis == 2) ? b : a);
-            int lz = (axis == 2) ? fixed : ((axis == 0) ? b : b);
-            BlockType currentBlock = current.get(lx, ly, lz);
-            BlockType neighBlock;
-            if (neighbor) {
-                neighBlock = neighbor->get(neighX + (axis==0 ? 0 : (axis==1 ? a : a)),  
-                                          neighY + (axis==1 ? 0 : (axis==2 ? b : a)),
-                                          neighZ + (axis==2 ? 0 : (axis==0 ? b : b)));
-            } else {
-                neighBlock = BlockType::AIR;
-            }
-            mask[a][b] = (currentBlock == BlockType::SOLID && neighBlock == BlockType::AIR);  
+            int lz = (axis == 2) ? fixed : b;
+            BlockType currentBlock = padded.get(lx, ly, lz);
+            BlockType neighBlock = padded.get(axis == 0 ? adjacent : lx,
+                                              axis == 1 ? adjacent : ly,
+                                              axis == 2 ? adjacent : lz);
+            mask[a][b] = (currentBlock == BlockType::SOLID && neighBlock != BlockType::SOLID);
         }
     }
-    
+
     for (int a = 0; a < sizeA; ++a) {
         for (int b = 0; b < sizeB; ) {
             if (!mask[a][b]) { ++b; continue; }
@@ -260,7 +436,7 @@ void World::greedyMeshSlice(const Chunk& current, const Chunk* neighbor, int fix
             if (axis == 0) pos = {fixed, a, b};
             else if (axis == 1) pos = {a, fixed, b};
             else pos = {a, b, fixed};
-            emitGreedyFace(pos, dir, h, w, globalOffset, vertices, indices);
+            emitGreedyFace(pos, dir, h, w, chunkCoord, mesh);
             for (int aa = 0; aa < h; ++aa) {
                 for (int bb = 0; bb < w; ++bb) {
                     mask[a + aa][b + bb] = false;
@@ -272,166 +448,467 @@ void World::greedyMeshSlice(const Chunk& current, const Chunk* neighbor, int fix
 }
 
 
-void World::generateChunkMesh(glm::ivec3 chunkCoord, Chunk& currentChunk, std::vector<Vertex>& vertices, std::vector<GLuint>& indices) {
-    {
-        std::unique_lock<std::mutex> lock(ChunkMapMutex);
-        if (chunks.find(chunkCoord) == chunks.end()) return;
+void World::generateChunkMesh(glm::ivec3 chunkCoord, const Chunk& currentChunk, WorkResult& mesh) {
+    // The refs keep neighbours alive even if ChunkManager unloads them
+    // while this chunk is being meshed.
+    std::array<ChunkRef, 6> neighborRefs;
+    std::array<const Chunk*, 6> neighborChunks{};
+    for (int d = 0; d < 6; ++d) {
+        int axis = d / 2;
+        int delta = (d % 2 == 0) ? 1 : -1;
+        glm::ivec3 neighC = chunkCoord;
+        neighC[axis] += delta;
+        neighborRefs[d] = chunks.Get(neighC);
+        neighborChunks[d] = neighborRefs[d].get();
+        if (neighborChunks[d]) mesh.neighborMask |= static_cast<uint8_t>(1u << d);
     }
-    glm::ivec3 globalOffset = chunkCoord * glm::ivec3(CHUNK_SIZE);
+    if (!chunks.Contains(chunkCoord)) return;
 
-    
-    std::array<const Chunk*, 6> neighborChunks{};
-    {
-        std::unique_lock<std::mutex> lock(ChunkMapMutex);
-        for (int d = 0; d < 6; ++d) {
-            int axis = d / 2;
-            int delta = (d % 2 == 0) ? 1 : -1;
-            glm::ivec3 neighC = chunkCoord;
-            neighC[axis] += delta;
-            auto it = chunks.find(neighC);
-            if (it != chunks.end()) {
-                neighborChunks[d] = &it->second;
+    if (uniformShortcut && currentChunk.isUniform()) {
+        if (currentChunk.uniformBlock() != BlockType::SOLID) return;
+        bool enclosed = true;
+        for (const Chunk* neighbor : neighborChunks) {
+            if (!neighbor || !neighbor->isUniform() || neighbor->uniformBlock() != BlockType::SOLID) {
+                enclosed = false;
+                break;
             }
         }
+        if (enclosed) return;
     }
 
-    
-    
-    {
-        direction dir = direction::POSITIVE_X;
-        const Chunk* neigh = neighborChunks[0];
-        int localN = 0;
-        for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
-            greedyMeshSlice(currentChunk, neigh, fixed, dir, localN, globalOffset, vertices, indices);
-        }
+    // Everything below reads only this local copy, so the inner loops need
+    // no neighbour lookups or bounds checks.
+    PaddedChunk padded;
+    padded.gather(currentChunk, neighborChunks);
+
+    if (mesher == MesherKind::Binary) {
+        binaryMeshChunk(chunkCoord, padded, mesh);
+        return;
     }
-    
-    {
-        direction dir = direction::NEGATIVE_X;
-        const Chunk* neigh = neighborChunks[1];
-        int localN = CHUNK_SIZE - 1;
+    for (int d = 0; d < 6; ++d) {
         for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
-            greedyMeshSlice(currentChunk, neigh, fixed, dir, localN, globalOffset, vertices, indices);
+            greedyMeshSlice(padded, fixed, static_cast<direction>(d), chunkCoord, mesh);
         }
     }
-    
-    {
-        direction dir = direction::POSITIVE_Y;
-        const Chunk* neigh = neighborChunks[2];
-        int localN = 0;
-        for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
-            greedyMeshSlice(currentChunk, neigh, fixed, dir, localN, globalOffset, vertices, indices);
-        }
+}
+
+// Bit i of the result is set when padded row (y, z) is solid at x = i - 1.
+static uint64_t SolidRowBits(const PaddedChunk& padded, int y, int z) {
+    const BlockType* row = &padded.blocks[PaddedChunk::Index(-1, y, z)];
+    uint64_t bits = 0;
+    int x = 0;
+#if defined(__SSE2__)
+    const __m128i solid = _mm_set1_epi8(static_cast<char>(BlockType::SOLID));
+    for (; x + 16 <= PaddedChunk::PS; x += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        uint32_t m = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, solid)));
+        bits |= static_cast<uint64_t>(m) << x;
     }
-    
-    {
-        direction dir = direction::NEGATIVE_Y;
-        const Chunk* neigh = neighborChunks[3];
-        int localN = CHUNK_SIZE - 1;
-        for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
-            greedyMeshSlice(currentChunk, neigh, fixed, dir, localN, globalOffset, vertices, indices);
-        }
+#endif
+    for (; x < PaddedChunk::PS; ++x) {
+        bits |= static_cast<uint64_t>(row[x] == BlockType::SOLID) << x;
     }
-    
-    {
-        direction dir = direction::POSITIVE_Z;
-        const Chunk* neigh = neighborChunks[4];
-        int localN = 0;
-        for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
-            greedyMeshSlice(currentChunk, neigh, fixed, dir, localN, globalOffset, vertices, indices);
+    return bits;
+}
+
+void World::binaryMeshChunk(glm::ivec3 chunkCoord, const PaddedChunk& padded, WorkResult& mesh) {
+    // Solidity is held as one bit column per (u, v) pair for each axis, in
+    // padded coordinates where 0 and CS + 1 are the neighbouring chunks'
+    // border layers. Column order matches greedyMeshSlice's (a, b) order:
+    // X columns are indexed by (y, z), Y columns by (x, z), Z by (x, y).
+    constexpr int CS = CHUNK_SIZE;
+    constexpr int PS = PaddedChunk::PS;
+    static_assert(PS <= 64, "binary mesher keeps padded columns in 64 bits");
+    uint64_t columns[3][PS][PS] = {};
+    for (int z = -1; z <= CS; ++z) {
+        bool zInside = (z >= 0 && z < CS);
+        for (int y = -1; y <= CS; ++y) {
+            bool yInside = (y >= 0 && y < CS);
+            if (!yInside && !zInside) continue;
+            uint64_t row = SolidRowBits(padded, y, z);
+            if (yInside && zInside) columns[0][y + 1][z + 1] = row;
+            uint64_t yBit = zInside ? 1ull << (y + 1) : 0;
+            uint64_t zBit = yInside ? 1ull << (z + 1) : 0;
+            for (int x = 0; x < CS; ++x) {
+                uint64_t solid = 0 - ((row >> (x + 1)) & 1);
+                columns[1][x + 1][z + 1] |= solid & yBit;
+                columns[2][x + 1][y + 1] |= solid & zBit;
+            }
         }
     }
-    
-    {
-        direction dir = direction::NEGATIVE_Z;
-        const Chunk* neigh = neighborChunks[5];
-        int localN = CHUNK_SIZE - 1;
-        for (int fixed = 0; fixed < CHUNK_SIZE; ++fixed) {
-            greedyMeshSlice(currentChunk, neigh, fixed, dir, localN, globalOffset, vertices, indices);
+
+    constexpr uint64_t interior = ((1ull << CS) - 1) << 1;
+    uint64_t planes[CS][CS];
+    for (int d = 0; d < 6; ++d) {
+        int axis = d / 2;
+        bool isPos = (d % 2 == 0);
+        direction dir = static_cast<direction>(d);
+        std::fill_n(&planes[0][0], CS * CS, 0ull);
+        int faceCount = 0;
+        for (int a = 0; a < CS; ++a) {
+            for (int b = 0; b < CS; ++b) {
+                uint64_t col = columns[axis][a + 1][b + 1];
+                uint64_t faces = isPos ? (col & ~(col >> 1)) : (col & ~(col << 1));
+                faces = (faces & interior) >> 1;
+                faceCount += __builtin_popcountll(faces);
+                while (faces) {
+                    int depth = __builtin_ctzll(faces);
+                    planes[depth][a] |= 1ull << b;
+                    faces &= faces - 1;
+                }
+            }
+        }
+        if (faceCount == 0) continue;
+
+        for (int depth = 0; depth < CS; ++depth) {
+            uint64_t* rows = planes[depth];
+            for (int a = 0; a < CS; ++a) {
+                while (rows[a]) {
+                    int b = __builtin_ctzll(rows[a]);
+                    uint64_t run = rows[a] >> b;
+                    int w = (~run == 0) ? 64 - b : __builtin_ctzll(~run);
+                    uint64_t runMask = ((w >= 64) ? ~0ull : ((1ull << w) - 1)) << b;
+                    rows[a] &= ~runMask;
+                    int h = 1;
+                    while (a + h < CS && (rows[a + h] & runMask) == runMask) {
+                        rows[a + h] &= ~runMask;
+                        ++h;
+                    }
+                    i_vec3 pos;
+                    if (axis == 0) pos = {depth, a, b};
+                    else if (axis == 1) pos = {a, depth, b};
+                    else pos = {a, b, depth};
+                    emitGreedyFace(pos, dir, h, w, chunkCoord, mesh);
+                }
+            }
         }
     }
 }
 
-void World::ChunkManager(glm::vec3& cameraPosition, int renderRadius) {
-    glm::ivec3 camChunkCoord = glm::floor(cameraPosition / static_cast<float>(CHUNK_SIZE));
-    std::vector<glm::ivec3> toUnload;
-    {
-        std::unique_lock<std::mutex> lock(ChunkMapMutex);
-        for (const auto& p : chunks) {
-            glm::ivec3 coord = p.first;
-            glm::vec3 delta = glm::abs(glm::vec3(coord - camChunkCoord));
-            float maxDist = std::max({delta.x, delta.y, delta.z});
-            if (maxDist > renderRadius + 1) {
-                toUnload.push_back(coord);
-            }
+void World::setMesher(MesherKind kind) {
+    mesher = kind;
+}
+
+void World::setUniformShortcut(bool enabled) {
+    uniformShortcut = enabled;
+}
+
+// A solid block has a face only where it borders air: the top of its own
+// column, or the side of a lower neighbouring column. So the chunks that can
+// hold faces run from the lowest of those to the highest solid block.
+glm::ivec2 World::surfaceBand(glm::ivec2 column) {
+    auto it = surfaceBands.find(column);
+    if (it != surfaceBands.end()) return it->second;
+    const glm::ivec2 around[5] = {{0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    ColumnHeights heights;
+    int low = INT_MAX;
+    int high = INT_MIN;
+    for (const glm::ivec2& d : around) {
+        if (!heightmaps.Get(column + d, heights)) {
+            // Stored for the jobs that generate these columns later.
+            columnHeights(column + d, heights);
+            heightmaps.Put(column + d, heights);
         }
-        for (const auto& coord : toUnload) {
-            chunks.erase(coord);
+        int minHeight = *std::min_element(heights.begin(), heights.end());
+        if (d == glm::ivec2(0)) {
+            low = std::min(low, minHeight - 1);
+            high = *std::max_element(heights.begin(), heights.end()) - 1;
+        } else {
+            low = std::min(low, minHeight);
         }
     }
-    {
-        std::unique_lock<std::mutex> lock(resultMutex);
-        for (const auto& coord : toUnload) {
-            generatedMeshes.erase(coord);
+    glm::ivec2 band(FloorDiv(low, CHUNK_SIZE), FloorDiv(high, CHUNK_SIZE));
+    surfaceBands.emplace(column, band);
+    return band;
+}
+
+void World::ChunkManager(glm::vec3& cameraPosition, int renderRadius, size_t scanBudget) {
+    glm::ivec3 camChunkCoord = glm::floor(cameraPosition / static_cast<float>(CHUNK_SIZE));
+    int verticalRadius = regionShape == RegionShape::Cube ? renderRadius : std::clamp(regionVerticalRadius, 0, renderRadius);
+    bool squareFootprint = regionShape == RegionShape::Cube || lodRings.Levels() > 0;
+    cameraChunk.store(PackChunkCoord(camChunkCoord), std::memory_order_relaxed);
+    activeRadius.store(renderRadius, std::memory_order_relaxed);
+    activeShape.store(regionShape, std::memory_order_relaxed);
+    activeVerticalRadius.store(verticalRadius, std::memory_order_relaxed);
+    activeSquareFootprint.store(squareFootprint, std::memory_order_relaxed);
+    epoch.fetch_add(1, std::memory_order_release);
+    // Loaded chunks are kept one ring past the render radius so crossing
+    // back over a border does not regenerate them.
+    unloadChunks(chunks.Recenter(camChunkCoord, renderRadius + 1));
+    heightmaps.Recenter(glm::ivec2(camChunkCoord.x, camChunkCoord.z), renderRadius + 1);
+    for (auto it = surfaceBands.begin(); it != surfaceBands.end();) {
+        glm::ivec2 delta = glm::abs(it->first - glm::ivec2(camChunkCoord.x, camChunkCoord.z));
+        if (std::max(delta.x, delta.y) > renderRadius) {
+            it = surfaceBands.erase(it);
+        } else {
+            ++it;
         }
     }
-    std::vector<glm::ivec3> toGenerate;
-    {
-        std::unique_lock<std::mutex> lock(ChunkMapMutex);
+    auto inRange = [&](glm::ivec3 coord) {
+        if (!InRegionShape(regionShape, coord - camChunkCoord, renderRadius, verticalRadius, squareFootprint)) return false;
+        if (!regionClampToTerrain) return true;
+        glm::ivec2 band = surfaceBand(glm::ivec2(coord.x, coord.z));
+        return coord.y >= band.x && coord.y <= band.y;
+    };
+    // Unstarted work that left the radius; finished chunks stay until they
+    // are unloaded above.
+    chunkStates.EraseIf([&](glm::ivec3 coord, ChunkState state) {
+        return state == ChunkState::Queued && !inRange(coord);
+    });
+    pendingChunks.erase(std::remove_if(pendingChunks.begin(), pendingChunks.end(),
+                                       [&](glm::ivec3 coord) { return !inRange(coord); }),
+                        pendingChunks.end());
+    if (scanOffsetsRadius != renderRadius || scanOffsetsSorted != prioritized || scanOffsetsSquare != squareFootprint || regionDirty) {
+        scanOffsets.clear();
         for (int dx = -renderRadius; dx <= renderRadius; ++dx) {
-            for (int dy = -renderRadius; dy <= renderRadius; ++dy) {
+            for (int dy = -verticalRadius; dy <= verticalRadius; ++dy) {
                 for (int dz = -renderRadius; dz <= renderRadius; ++dz) {
-                    glm::ivec3 targetCoord = camChunkCoord + glm::ivec3(dx, dy, dz);
-                    glm::vec3 delta = glm::abs(glm::vec3(glm::ivec3(dx, dy, dz)));
-                    float maxDist = std::max({delta.x, delta.y, delta.z});
-                    if (maxDist <= static_cast<float>(renderRadius) && chunks.find(targetCoord) == chunks.end()) {
-                        toGenerate.push_back(targetCoord);
+                    glm::ivec3 offset(dx, dy, dz);
+                    if (InRegionShape(regionShape, offset, renderRadius, verticalRadius, squareFootprint)) {
+                        scanOffsets.push_back(offset);
                     }
                 }
             }
         }
+        if (prioritized) {
+            std::stable_sort(scanOffsets.begin(), scanOffsets.end(), [](glm::ivec3 a, glm::ivec3 b) {
+                return a.x * a.x + a.y * a.y + a.z * a.z < b.x * b.x + b.y * b.y + b.z * b.z;
+            });
+        }
+        scanOffsetsRadius = renderRadius;
+        scanOffsetsSorted = prioritized;
+        scanOffsetsSquare = squareFootprint;
+        regionDirty = false;
     }
-    {
-        std::unique_lock<std::mutex> lock(workerMutex);
-        for (const auto& coord : toGenerate) {
-            ChunksToGenerate.push(coord);
+    scanCenter = camChunkCoord;
+    scanCursor = 0;
+    pendingDirty = true;
+    scanChunks(scanBudget);
+    lodRings.Recenter(camChunkCoord, glm::ivec3(renderRadius, verticalRadius, renderRadius), evictedLodMeshes);
+}
+
+size_t World::scanChunks(size_t maxCoords) {
+    size_t end = scanOffsets.size() - scanCursor > maxCoords ? scanCursor + maxCoords : scanOffsets.size();
+    for (; scanCursor < end; ++scanCursor) {
+        glm::ivec3 targetCoord = scanCenter + scanOffsets[scanCursor];
+        if (regionClampToTerrain) {
+            glm::ivec2 band = surfaceBand(glm::ivec2(targetCoord.x, targetCoord.z));
+            if (targetCoord.y < band.x || targetCoord.y > band.y) continue;
+        }
+        if (chunkStates.TryInsert(targetCoord, ChunkState::Queued)) {
+            pendingChunks.push_back(targetCoord);
+            pendingDirty = true;
         }
     }
-    cv.notify_all();
+    return scanOffsets.size() - scanCursor;
 }
 
-void World::fetchMergedMesh(std::vector<Vertex>& outVertices, std::vector<GLuint>& outIndices) {
+void World::unloadChunks(const std::vector<glm::ivec3>& coords) {
+    drainCompletedMeshes();
+    for (const auto& coord : coords) {
+        if (generatedMeshes.erase(coord) > 0) {
+            evictedMeshes.push_back(coord);
+        }
+        finishedMeshes.erase(coord);
+        meshCopies.erase(coord);
+        chunkStates.Erase(coord);
+    }
+}
+
+void World::setChunkWindow(glm::ivec3 centerChunk, int radius) {
+    unloadChunks(chunks.Recenter(centerChunk, radius));
+    heightmaps.Recenter(glm::ivec2(centerChunk.x, centerChunk.z), radius);
+}
+
+void World::sortPendingChunks(glm::ivec3 cameraChunk, const glm::vec3& viewDirection) {
+    glm::vec3 view = glm::length(viewDirection) > 0.0f ? glm::normalize(viewDirection) : glm::vec3(0.0f);
+    auto priority = [&](glm::ivec3 coord) {
+        glm::vec3 offset = glm::vec3(coord - cameraChunk);
+        float distance = glm::length(offset);
+        if (distance == 0.0f) return 0.0f;
+        float facing = std::max(0.0f, glm::dot(offset / distance, view));
+        return distance * (1.0f - 0.5f * facing);
+    };
+    // Best candidate last so scheduleChunks can pop from the back.
+    std::sort(pendingChunks.begin(), pendingChunks.end(), [&](glm::ivec3 a, glm::ivec3 b) {
+        return priority(a) > priority(b);
+    });
+}
+
+void World::scheduleChunks(const glm::vec3& cameraPosition, const glm::vec3& viewDirection) {
+    if (pendingChunks.empty() && lodRings.PendingCount() == 0) return;
+    int freeSlots = maxChunksInFlight - chunksInFlight.load(std::memory_order_relaxed);
+    if (freeSlots <= 0) return;
+    // Far columns get a share of the slots even while nearby chunks are
+    // still streaming in, and whatever nearby chunks leave unused.
+    size_t lodTake = 0;
+    if (lodRings.PendingCount() > 0) {
+        size_t share = static_cast<size_t>(std::max(1, maxChunksInFlight / 4));
+        size_t unused = static_cast<size_t>(freeSlots) - std::min(static_cast<size_t>(freeSlots), pendingChunks.size());
+        lodTake = std::min(static_cast<size_t>(freeSlots), std::max(share, unused));
+        std::vector<LodBuild> builds;
+        lodTake = lodRings.TakeBuilds(lodTake, builds);
+        for (const LodBuild& build : builds) {
+            chunksInFlight.fetch_add(1, std::memory_order_relaxed);
+            jobs.Submit([this, build]() { buildLodColumn(build); });
+        }
+        freeSlots -= static_cast<int>(lodTake);
+    }
+    if (pendingChunks.empty() || freeSlots <= 0) return;
+    glm::ivec3 camChunkCoord = glm::floor(cameraPosition / static_cast<float>(CHUNK_SIZE));
+    if (prioritized) {
+        // Re-sort when the camera changes chunk or turns noticeably; between
+        // those the order is still good enough.
+        bool turned = glm::dot(viewDirection, lastScheduleView) < 0.95f * glm::length(viewDirection) * glm::length(lastScheduleView);
+        if (pendingDirty || camChunkCoord != lastScheduleChunk || turned) {
+            sortPendingChunks(camChunkCoord, viewDirection);
+            lastScheduleChunk = camChunkCoord;
+            lastScheduleView = viewDirection;
+        }
+    }
+    pendingDirty = false;
+    size_t take = std::min(pendingChunks.size(), static_cast<size_t>(freeSlots));
+    // Sorted lists give up their best entries from the back; unsorted ones
+    // keep ChunkManager's loop order and give up the front.
+    auto first = prioritized ? pendingChunks.end() - take : pendingChunks.begin();
+    uint32_t ticket = epoch.load(std::memory_order_relaxed);
+    for (auto it = first; it != first + take; ++it) {
+        glm::ivec3 coord = *it;
+        chunksInFlight.fetch_add(1, std::memory_order_relaxed);
+        jobs.Submit([this, coord, ticket]() { buildChunk(coord, ticket); });
+    }
+    pendingChunks.erase(first, first + take);
+}
+
+void World::setRenderRegion(RegionShape shape, int verticalRadius, bool clampToTerrain) {
+    regionShape = shape;
+    regionVerticalRadius = verticalRadius;
+    regionClampToTerrain = clampToTerrain;
+    regionDirty = true;
+}
+
+void World::setPrioritizedScheduling(bool enabled) {
+    prioritized = enabled;
+    pendingDirty = true;
+}
+
+void World::setStaleChecks(bool enabled) {
+    staleChecks.store(enabled, std::memory_order_relaxed);
+}
+
+void World::setLodLevels(int levels, int radius) {
+    lodRings.Configure(levels, radius, evictedLodMeshes);
+}
+
+void World::fetchLodUpdates(std::vector<WorkResult>& outFinished, std::vector<glm::ivec4>& outEvicted) {
+    LodColumnResult result;
+    std::vector<int> chunkYs;
+    while (completedLodColumns.TryPop(result)) {
+        chunkYs.clear();
+        for (const auto& mesh : result.meshes) chunkYs.push_back(mesh.coord.y);
+        if (!lodRings.Complete(result.build, result.surfaceMinY, result.surfaceMaxY, chunkYs, evictedLodMeshes)) continue;
+        for (auto& mesh : result.meshes) outFinished.push_back(std::move(mesh));
+    }
+    outEvicted.insert(outEvicted.end(), evictedLodMeshes.begin(), evictedLodMeshes.end());
+    evictedLodMeshes.clear();
+}
+
+size_t World::pendingLodColumnCount() const {
+    return lodRings.PendingCount();
+}
+
+const LodRings& World::getLodRings() const {
+    return lodRings;
+}
+
+WorkCounters World::getWorkCounters() const {
+    WorkCounters counters;
+    counters.generations = workStats.generations.load(std::memory_order_relaxed);
+    counters.cancelled = workStats.cancelled.load(std::memory_order_relaxed);
+    counters.wastedGenerations = workStats.wastedGenerations.load(std::memory_order_relaxed);
+    counters.wastedMeshes = workStats.wastedMeshes.load(std::memory_order_relaxed);
+    counters.remeshes = workStats.remeshes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+ChunkStateTable::Counts World::getChunkStateCounts() const {
+    return chunkStates.GetCounts();
+}
+
+void World::markUploaded(glm::ivec3 chunkCoord) {
+    chunkStates.Transition(chunkCoord, ChunkState::Meshed, ChunkState::Uploaded);
+}
+
+size_t World::pendingChunkCount() const {
+    return pendingChunks.size();
+}
+
+void World::fetchMergedMesh(std::vector<PackedVertex>& outVertices, std::vector<GLuint>& outIndices, std::vector<PackedQuad>& outQuads, std::vector<DrawElementsCommand>& outCommands) {
     outVertices.clear();
     outIndices.clear();
+    outQuads.clear();
+    outCommands.clear();
+    drainCompletedMeshes();
     {
-        std::unique_lock<std::mutex> lock(resultMutex);
         size_t estVerts = 0;
-        for (const auto& p : generatedMeshes) estVerts += p.second.vertices.size();  
+        size_t estIndices = 0;
+        size_t estQuads = 0;
+        for (const auto& p : meshCopies) {
+            estVerts += p.second.vertices.size();
+            estIndices += p.second.indices.size();
+            estQuads += p.second.quads.size();
+        }
         outVertices.reserve(estVerts);
-        outIndices.reserve(estVerts * 1.5);  
-        GLuint offset = 0;
-        for (const auto& p : generatedMeshes) {
+        outIndices.reserve(estIndices);
+        outQuads.reserve(estQuads);
+        outCommands.reserve(meshCopies.size());
+        for (const auto& p : meshCopies) {
             const auto& res = p.second;
-            GLuint currOffset = static_cast<GLuint>(outVertices.size());
-            for (GLuint idx : res.indices) {
-                outIndices.push_back(idx + currOffset);
-            }
+            outQuads.insert(outQuads.end(), res.quads.begin(), res.quads.end());
+            if (res.indices.empty()) continue;
+            DrawElementsCommand cmd;
+            cmd.count = static_cast<GLuint>(res.indices.size());
+            cmd.instanceCount = 1;
+            cmd.firstIndex = static_cast<GLuint>(outIndices.size());
+            cmd.baseVertex = static_cast<GLint>(outVertices.size());
+            cmd.baseInstance = 0;
+            outCommands.push_back(cmd);
+            outIndices.insert(outIndices.end(), res.indices.begin(), res.indices.end());
             outVertices.insert(outVertices.end(), res.vertices.begin(), res.vertices.end());
         }
     }
 }
 
-std::vector<Vertex>& World::getVerticesReference() {
-    return GlobalVertices;
+void World::setKeepMeshCopies(bool enabled) {
+    keepMeshCopies = enabled;
+    if (!enabled) meshCopies.clear();
 }
-std::vector<GLuint>& World::getIndicesReference() {
-    return GlobalIndices;
+
+void World::fetchMeshUpdates(std::vector<WorkResult>& outFinished, std::vector<glm::ivec3>& outEvicted) {
+    drainCompletedMeshes();
+    outEvicted.insert(outEvicted.end(), evictedMeshes.begin(), evictedMeshes.end());
+    evictedMeshes.clear();
+    for (auto& p : finishedMeshes) {
+        outFinished.push_back(std::move(p.second));
+    }
+    finishedMeshes.clear();
+}
+
+void World::storeChunk(glm::ivec3 chunkCoord, const Chunk& chunk) {
+    chunks.Put(chunkCoord, std::make_shared<const Chunk>(chunk));
+}
+
+void World::storeMesh(WorkResult mesh) {
+    acceptMesh(std::move(mesh));
+}
+
+MeshFormat World::getMeshFormat() const {
+    return meshFormat;
+}
+
+void World::waitForJobs() {
+    jobs.Wait();
 }
 
 World::~World() {
-    running = false;
-    cv.notify_all();
-    for (auto& w : workers) {
-        if (w.joinable()) w.join();
-    }
 }
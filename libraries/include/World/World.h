@@ -1,6 +1,7 @@
 #ifndef WORLD_H
 #define WORLD_H
 #include <atomic>
+#include <cstdint>
 #include <condition_variable>
 #include <glm/ext/vector_float3.hpp>
 #include <glm/ext/vector_int3.hpp>
@@ -21,18 +22,20 @@
 #include <glm/gtx/hash.hpp>  // For ivec3/ivec2 hashing
 #include "../glad/glad.h"
 #include "../VBO/VBO.h"
+#include "../EBO/EBO.h"
 #include "../PerlinNoise-3.0.0/PerlinNoise.hpp"
-#define CHUNK_SIZE 16
+#include "../HeightNoise/HeightNoise.h"
+#include "../HeightmapStore/HeightmapStore.h"
+#include "../Chunk/Chunk.h"
+#include "../ChunkStore/ChunkStore.h"
+#include "../JobSystem/JobSystem.h"
+#include "../ChunkStateTable/ChunkStateTable.h"
+#include "../LodRings/LodRings.h"
 using vec3 = glm::vec3;
 using i_vec3 = glm::ivec3;
 using i_vec2 = glm::ivec2;  // NEW: For height cache
 using u_int32_t = GLuint;
 using u_int8_t = uint8_t;
-enum class BlockType {
-    NONE,
-    SOLID,
-    AIR
-};
 enum class direction {
     POSITIVE_X = 0,
     NEGATIVE_X,
@@ -41,44 +44,90 @@ enum class direction {
     POSITIVE_Z,
     NEGATIVE_Z
 };
-struct Chunk {
-    static constexpr int CS = CHUNK_SIZE;
-    static constexpr int CS_SQR = CS * CS;
-    std::array<BlockType, CS * CS * CS> blocks{};
-
-    BlockType& get(int x, int y, int z) {
-        return blocks[x + y * CS + z * CS_SQR];
-    }
-    const BlockType& get(int x, int y, int z) const {
-        return blocks[x + y * CS + z * CS_SQR];
-    }
-
-    void initToAir() {
-        std::fill(blocks.begin(), blocks.end(), BlockType::AIR);
-    }
+// IndexedVertices emits 4 packed vertices and 6 indices per greedy quad.
+// PulledQuads emits one PackedQuad per greedy quad and the vertex shader
+// expands it from gl_VertexID, so no index buffer is needed.
+enum class MeshFormat {
+    IndexedVertices,
+    PulledQuads
+};
+// Reference is the slice-by-slice mesher in greedyMeshSlice; Binary builds
+// the same quads from per-axis bit columns.
+enum class MesherKind {
+    Reference,
+    Binary
+};
+// Shape of the region ChunkManager loads around the camera chunk. Cube is
+// the full (2R+1)^3 block; Cylinder and Ellipsoid have their own vertical
+// radius, since terrain is far wider than it is tall.
+enum class RegionShape {
+    Cube,
+    Cylinder,
+    Ellipsoid
 };
 struct WorkResult{
     glm::ivec3 coord;
-    std::vector<Vertex> vertices;
+    std::vector<PackedVertex> vertices;
     std::vector<GLuint> indices;
+    std::vector<PackedQuad> quads;
+    // Bit d is set when the neighbour in direction d was loaded while
+    // meshing; faces toward a missing neighbour are emitted as if it were air.
+    uint8_t neighborMask = 0;
+    // 0 for full-resolution chunks; see LodRings for coarser levels.
+    int lod = 0;
+};
+// Meshes of one far terrain column, handed from a job to the main thread.
+struct LodColumnResult {
+    LodBuild build;
+    int surfaceMinY = 0;
+    int surfaceMaxY = -1;
+    std::vector<WorkResult> meshes;
+};
+// Jobs dropped because the camera moved away before they finished.
+// cancelled jobs were skipped before any work; the other two threw away a
+// generated chunk or a finished mesh.
+struct WorkCounters {
+    // Chunks whose blocks were filled, delivered or not.
+    uint64_t generations = 0;
+    uint64_t cancelled = 0;
+    uint64_t wastedGenerations = 0;
+    uint64_t wastedMeshes = 0;
+    // Chunks meshed again because a neighbour arrived after their mesh.
+    uint64_t remeshes = 0;
 };
 class World {
 private:
-    std::vector<Vertex> GlobalVertices;
-    std::vector<GLuint> GlobalIndices;
-    std::unordered_map<glm::ivec3, Chunk> chunks;
-    std::unordered_map<glm::ivec3, WorkResult> generatedMeshes;
+    MeshFormat meshFormat;
+    std::atomic<MesherKind> mesher{MesherKind::Binary};
+    std::atomic<bool> uniformShortcut{true};
+    ChunkStore chunks;
+    // Main thread only; jobs hand results over through completedMeshes.
+    // Geometry is not kept once fetchMeshUpdates hands it to the renderer:
+    // generatedMeshes only remembers which chunks have a mesh out and which
+    // neighbours it saw, and finishedMeshes holds the newest mesh of each
+    // chunk until it is fetched.
+    struct MeshInfo {
+        uint8_t neighborMask = 0;
+    };
+    std::unordered_map<glm::ivec3, MeshInfo> generatedMeshes;
+    std::unordered_map<glm::ivec3, WorkResult> finishedMeshes;
+    std::vector<glm::ivec3> evictedMeshes;
+    // Copies of every resident mesh for fetchMergedMesh; off unless
+    // voxel_bench asks for them.
+    bool keepMeshCopies = false;
+    std::unordered_map<glm::ivec3, WorkResult> meshCopies;
+    void acceptMesh(WorkResult mesh);
     siv::PerlinNoise m_noise;
-    // NEW: Height cache for noise (per global XZ column)
-    std::unordered_map<glm::ivec2, int> heightCache;
-    std::mutex heightCacheMutex;
-    std::vector<std::thread> workers;
-    std::queue<glm::ivec3> ChunksToGenerate;
-    std::atomic<bool> running{true};
-    std::mutex workerMutex;
-    std::mutex resultMutex;
-    std::mutex ChunkMapMutex;
-    std::condition_variable cv;
+    HeightNoise heightNoise;
+    // Follows the chunk window in x and z.
+    HeightmapStore heightmaps;
+    // Meshes finished by jobs; drained into finishedMeshes on the main thread.
+    MpscQueue<WorkResult> completedMeshes;
+    // Far terrain around the full-resolution cube. Main thread only; jobs
+    // hand results over through completedLodColumns.
+    LodRings lodRings;
+    MpscQueue<LodColumnResult> completedLodColumns;
+    std::vector<glm::ivec4> evictedLodMeshes;
     static constexpr glm::vec3 facePos[6][4] = {
         { {1,0,0}, {1,1,0}, {1,1,1}, {1,0,1} },
         { {0,0,0}, {0,0,1}, {0,1,1}, {0,1,0} },
@@ -95,19 +144,142 @@ private:
         {0,0,1},
         {0,0,-1}
     };
+    // Coordinates ChunkManager wants built, waiting for a free job slot.
+    // Main thread only; kept sorted so the best candidate is at the back.
+    std::vector<glm::ivec3> pendingChunks;
+    // Every chunk from request to upload. ChunkManager only queues chunks
+    // with no entry, and jobs advance the state as they go so a chunk that
+    // was dropped and requested again is never built twice.
+    ChunkStateTable chunkStates;
+    bool pendingDirty = false;
+    bool prioritized = true;
+    // ChunkManager's scan of the render cube, resumed by scanChunks. Offsets
+    // run nearest first when prioritized, in plain loop order otherwise.
+    std::vector<glm::ivec3> scanOffsets;
+    int scanOffsetsRadius = -1;
+    bool scanOffsetsSorted = false;
+    bool scanOffsetsSquare = false;
+    bool regionDirty = true;
+    RegionShape regionShape = RegionShape::Cube;
+    int regionVerticalRadius = 0;
+    bool regionClampToTerrain = false;
+    // Chunk y range, inclusive, that can hold faces in each chunk column
+    // near the camera. Main thread only.
+    std::unordered_map<glm::ivec2, glm::ivec2> surfaceBands;
+    glm::ivec2 surfaceBand(glm::ivec2 column);
+    glm::ivec3 scanCenter{0};
+    size_t scanCursor = 0;
+    glm::ivec3 lastScheduleChunk{0};
+    glm::vec3 lastScheduleView{0.0f};
+    std::atomic<int> chunksInFlight{0};
+    int maxChunksInFlight = 4;
+    // Bumped by every ChunkManager call. Jobs carry the epoch they were
+    // submitted in and only re-check their range when it has changed.
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint64_t> cameraChunk{0};
+    std::atomic<int> activeRadius{0};
+    // The region shape ChunkManager last used, for isStale on the workers.
+    std::atomic<RegionShape> activeShape{RegionShape::Cube};
+    std::atomic<int> activeVerticalRadius{0};
+    std::atomic<bool> activeSquareFootprint{true};
+    // Off lets every job run to completion however far the camera moved.
+    std::atomic<bool> staleChecks{true};
+    struct {
+        std::atomic<uint64_t> generations{0};
+        std::atomic<uint64_t> cancelled{0};
+        std::atomic<uint64_t> wastedGenerations{0};
+        std::atomic<uint64_t> wastedMeshes{0};
+        std::atomic<uint64_t> remeshes{0};
+    } workStats;
+    bool isStale(glm::ivec3 chunkCoord, uint32_t ticket) const;
+    void sortPendingChunks(glm::ivec3 cameraChunk, const glm::vec3& viewDirection);
+    // Declared last so workers are joined before the state they touch goes away.
+    JobSystem jobs;
+    void buildChunk(glm::ivec3 chunkCoord, uint32_t ticket);
+    void buildLodColumn(const LodBuild& build);
+    void remeshChunk(glm::ivec3 chunkCoord);
+    // Queues remeshes for chunks whose mesh treated a now-loaded neighbour
+    // as air: the neighbours of chunkCoord when includeNeighbors is set, and
+    // chunkCoord itself if a neighbour missing from ownMask has arrived.
+    void requestRemeshes(glm::ivec3 chunkCoord, const Chunk& chunk, uint8_t ownMask, bool includeNeighbors);
+    void drainCompletedMeshes();
+    void unloadChunks(const std::vector<glm::ivec3>& coords);
 public:
-    World();
+    // workerCount < 0 uses one worker per hardware thread minus one.
+    World(MeshFormat format = MeshFormat::PulledQuads, int workerCount = -1);
     ~World();
     void setBlocks(glm::ivec3 chunkCoord , Chunk& currentChunk);
-    void emitFace(direction dir, i_vec3 localCoordinates, i_vec3 globalOffset, std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
-    void emitGreedyFace(i_vec3 localMinCorner, direction dir, int height, int width, i_vec3 globalOffset, std::vector<Vertex>& vertices , std::vector<GLuint>& indices);
+    // Terrain height of every block column in a chunk column, computed in
+    // one batched noise call.
+    void columnHeights(glm::ivec2 chunkColumn, ColumnHeights& heights) const;
+    // Terrain heights of a size.x by size.y grid of block columns starting
+    // at block (x, z) = origin, stride blocks apart, x-fastest. Safe to call
+    // from any thread.
+    void sampleHeights(glm::ivec2 origin, int stride, glm::ivec2 size, int* heights) const;
+    void emitFace(direction dir, i_vec3 localCoordinates, i_vec3 chunkCoord, std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices);
+    void emitGreedyFace(i_vec3 localMinCorner, direction dir, int height, int width, i_vec3 chunkCoord, WorkResult& mesh);
     // UPDATED: No lambdas; direct meshing
-    void greedyMeshSlice(const Chunk& current, const Chunk* neighbor, int fixed, direction dir, int localNeighCoord, i_vec3 globalOffset, std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
-    void generateChunkMesh(glm::ivec3 chunkCoord , Chunk& currentChunk, std::vector<Vertex>& vertices , std::vector<GLuint>& indices) ;
-    void ChunkManager(glm::vec3& cameraPosition, int renderRadius = 5);
-    void MergeChunks();
-    void fetchMergedMesh(std::vector<Vertex>& outVertices, std::vector<GLuint>& outIndices);
-    std::vector<Vertex>& getVerticesReference();
-    std::vector<GLuint>& getIndicesReference();
+    void greedyMeshSlice(const PaddedChunk& padded, int fixed, direction dir, i_vec3 chunkCoord, WorkResult& mesh);
+    void generateChunkMesh(glm::ivec3 chunkCoord , const Chunk& currentChunk, WorkResult& mesh) ;
+    void binaryMeshChunk(glm::ivec3 chunkCoord, const PaddedChunk& padded, WorkResult& mesh);
+    void setMesher(MesherKind kind);
+    // When enabled, setBlocks fills chunks wholly above or below the
+    // surface without sampling each cell and the mesher skips chunks that
+    // cannot produce faces. Exposed so voxel_bench can compare both paths.
+    void setUniformShortcut(bool enabled);
+    // Recentres the world on the camera and queues the chunks of the render
+    // cube that have no state yet. At most scanBudget coordinates are
+    // visited now; scanChunks continues the rest on later frames.
+    void ChunkManager(glm::vec3& cameraPosition, int renderRadius = 5, size_t scanBudget = SIZE_MAX);
+    // Resumes ChunkManager's scan for up to maxCoords coordinates and
+    // returns how many are left.
+    size_t scanChunks(size_t maxCoords);
+    // Call once per frame: hands the highest-priority pending chunks to the
+    // job system, keeping at most a few jobs in flight per worker so newly
+    // urgent chunks are not stuck behind a long backlog. Priority is
+    // distance from the camera, discounted for chunks in front of it.
+    void scheduleChunks(const glm::vec3& cameraPosition, const glm::vec3& viewDirection);
+    // false schedules in ChunkManager's loop order (voxel_bench baseline).
+    void setPrioritizedScheduling(bool enabled);
+    // false stops jobs checking whether the camera has left them behind;
+    // voxel_bench uses it to measure what the check saves.
+    void setStaleChecks(bool enabled);
+    // Region ChunkManager loads. verticalRadius (at most the render radius)
+    // applies to Cylinder and Ellipsoid. clampToTerrain also skips chunks
+    // that the heightmap shows are wholly above or below the surface,
+    // which cannot have faces. With LOD rings on, the region is the box the
+    // rings cut their hole for: a square footprint of the render radius and
+    // the vertical radius. Takes effect at the next ChunkManager call.
+    void setRenderRegion(RegionShape shape, int verticalRadius, bool clampToTerrain);
+    // Draws terrain past the render radius at 2x, 4x and 8x coarser cells,
+    // one level per ring, each ring `radius` of its own chunks wide. Takes
+    // effect at the next ChunkManager call; 0 levels turns it off.
+    void setLodLevels(int levels, int radius);
+    // Far terrain meshes finished since the last call, and the (coord, lod)
+    // keys of meshes that should be dropped.
+    void fetchLodUpdates(std::vector<WorkResult>& outFinished, std::vector<glm::ivec4>& outEvicted);
+    size_t pendingLodColumnCount() const;
+    const LodRings& getLodRings() const;
+    size_t pendingChunkCount() const;
+    WorkCounters getWorkCounters() const;
+    ChunkStateTable::Counts getChunkStateCounts() const;
+    // Called by the renderer once a mesh from fetchMeshUpdates is on the GPU.
+    void markUploaded(glm::ivec3 chunkCoord);
+    // Every resident mesh merged into one set of buffers. Only available
+    // after setKeepMeshCopies(true); used by voxel_bench.
+    void fetchMergedMesh(std::vector<PackedVertex>& outVertices, std::vector<GLuint>& outIndices, std::vector<PackedQuad>& outQuads, std::vector<DrawElementsCommand>& outCommands);
+    void setKeepMeshCopies(bool enabled);
+    // Moves out the meshes finished since the last call, newest per chunk.
+    void fetchMeshUpdates(std::vector<WorkResult>& outFinished, std::vector<glm::ivec3>& outEvicted);
+    // Insert results directly, bypassing the job queue (used by buildChunk
+    // and voxel_bench).
+    void storeChunk(glm::ivec3 chunkCoord, const Chunk& chunk);
+    // Moves the loaded-chunk window; ChunkManager does this itself, the
+    // bench uses it to place chunks without running the manager.
+    void setChunkWindow(glm::ivec3 centerChunk, int radius);
+    void storeMesh(WorkResult mesh);
+    // Blocks until queued generation jobs finish; used by voxel_bench.
+    void waitForJobs();
+    MeshFormat getMeshFormat() const;
 };
 #endif
@@ -12,6 +12,10 @@ void Camera::setProjection() {
     projection = glm::perspective(fov, aspectRatio, nearPlane, farPlane);
 }
 
+glm::mat4 Camera::getFarTerrainProjection() const {
+    return glm::perspective(fov, aspectRatio, farTerrainNearPlane, farTerrainFarPlane);
+}
+
 glm::mat4& Camera::getView() {
     return view;
 }
@@ -20,6 +24,10 @@ glm::mat4& Camera::getProjection() {
     return projection;
 }
 
+Frustum Camera::getFrustum() const {
+    return Frustum::FromMatrix(projection * view);
+}
+
 void Camera::processMouseMove(float xpos, float ypos)
 {
     if (firstMouse) {
@@ -12,6 +12,7 @@
 #include <glm/ext/vector_int4_sized.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/glm.hpp>
+#include "../Frustum/Frustum.h"
 
 class Camera{
 private:
@@ -32,7 +33,10 @@ public:
     float fov = 45;
     float aspectRatio = 16.f/9.f;
     float nearPlane = 1.0f;
-    float farPlane = 1000.0f;
+    float farPlane = 4000.0f;  // past the last LOD ring
+    // The clipmap is drawn in its own pass with a deeper depth range.
+    float farTerrainNearPlane = 4.0f;
+    float farTerrainFarPlane = 60000.0f;
 
     float yaw   = -90.0f;   
     float pitch = 0.0f;
@@ -53,6 +57,8 @@ public:
     void advance(glm::vec3 Target);
     glm::mat4& getView();
     glm::mat4& getProjection();
+    glm::mat4 getFarTerrainProjection() const;
+    Frustum getFrustum() const;
     void processMouseMove(float x , float y);
     void processKeyInput(int key , float deltaTime);
 };
@@ -0,0 +1,38 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec3 FragCoord;
+in vec3 Normal;
+in vec3 SunNormal;
+
+// Square the next finer level draws; empty for the finest level.
+uniform vec2 uInnerMin;
+uniform vec2 uInnerMax;
+
+void main() {
+    if (all(greaterThan(FragCoord.xz, uInnerMin)) && all(lessThan(FragCoord.xz, uInnerMax))) {
+        discard;
+    }
+
+    // Same shading as default.frag so the voxels drawn over it blend in.
+    vec3 N = normalize(Normal);
+    vec3 L = normalize(SunNormal);
+    vec3 V = normalize(-FragCoord);
+    vec3 H = normalize(L + V);
+
+    float ambientStrength  = 0.15;
+    float diffuseStrength  = 1.0;
+    float specularStrength = 0.6;
+    float shininess        = 12.0;
+
+    vec3 baseColor = vec3(0.21, 1.0, 0.25);
+
+    vec3 ambient = ambientStrength * baseColor;
+    float diff = max(dot(N, L), 0.0);
+    vec3 diffuse = diffuseStrength * diff * baseColor;
+    float spec = pow(max(dot(N, H), 0.0), shininess);
+    vec3 specular = specularStrength * spec * vec3(1.0);
+
+    FragColor = vec4(ambient + diffuse + specular, 1.0);
+}
@@ -0,0 +1,57 @@
+#version 330 core
+
+layout (location = 0) in uvec2 aGrid;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+uniform vec3 aSunNormal;
+uniform sampler2DArray uHeights;
+uniform int uLevel;
+uniform int uSize;
+uniform int uSpacing;
+uniform ivec2 uOrigin;
+uniform ivec2 uTexelOrigin;
+uniform int uMorph;
+
+out vec3 FragCoord;
+out vec3 Normal;
+out vec3 SunNormal;
+
+// Vertices per side over which a level blends into the next coarser one.
+const int MORPH_WIDTH = 16;
+
+float HeightAt(ivec2 grid) {
+    grid = clamp(grid, ivec2(0), ivec2(uSize - 1));
+    ivec2 texel = (uTexelOrigin + grid) % uSize;
+    return texelFetch(uHeights, ivec3(texel, uLevel), 0).r;
+}
+
+void main() {
+    SunNormal = aSunNormal;
+    ivec2 grid = ivec2(aGrid);
+    int last = uSize - 1;
+    float height = HeightAt(grid);
+
+    // The coarser level only has the even vertices, so towards the edge
+    // odd vertices slide onto the line between their even neighbours. At
+    // the edge both levels describe the same surface and meet without a
+    // crack.
+    if (uMorph == 1) {
+        ivec2 edge = min(grid, last - grid);
+        float blend = clamp(1.0 - float(min(edge.x, edge.y)) / float(MORPH_WIDTH), 0.0, 1.0);
+        ivec2 lo = grid & ivec2(~1);
+        ivec2 hi = min(lo + (grid & ivec2(1)) * 2, ivec2(last));
+        float coarse = 0.25 * (HeightAt(lo) + HeightAt(ivec2(hi.x, lo.y))
+                             + HeightAt(ivec2(lo.x, hi.y)) + HeightAt(hi));
+        height = mix(height, coarse, blend);
+    }
+
+    float dx = HeightAt(grid - ivec2(1, 0)) - HeightAt(grid + ivec2(1, 0));
+    float dz = HeightAt(grid - ivec2(0, 1)) - HeightAt(grid + ivec2(0, 1));
+    Normal = vec3(dx, 2.0 * float(uSpacing), dz);
+
+    vec2 xz = vec2((uOrigin + grid) * uSpacing);
+    vec3 aPos = vec3(xz.x, height, xz.y);
+    FragCoord = aPos;
+    gl_Position = ProjectionMatrix * ViewMatrix * vec4(aPos, 1.0);
+}
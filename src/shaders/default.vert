@@ -1,13 +1,27 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 0) in uvec2 aPacked;
 layout (location = 2) in vec3 aSkyBoxVert;
 
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
 uniform int isSkyBox;  
 uniform vec3 aSunNormal;
+uniform ivec3 uCameraChunk;
+uniform int uPullQuads;
+uniform usamplerBuffer uQuads;
+
+const int CHUNK_SIZE = 16;
+const vec3 FaceNormals[6] = vec3[6](
+    vec3( 1, 0, 0), vec3(-1, 0, 0),
+    vec3( 0, 1, 0), vec3( 0,-1, 0),
+    vec3( 0, 0, 1), vec3( 0, 0,-1)
+);
+// Quad corner per emitted vertex, matching the index order emitGreedyFace
+// uses; the second row is for faces whose winding is flipped.
+const int QuadCorners[12] = int[12](0, 2, 1, 2, 3, 1,  0, 1, 2, 1, 3, 2);
+const ivec3 HeightAxis[3] = ivec3[3](ivec3(0, 1, 0), ivec3(1, 0, 0), ivec3(1, 0, 0));
+const ivec3 WidthAxis[3] = ivec3[3](ivec3(0, 0, 1), ivec3(0, 0, 1), ivec3(0, 1, 0));
 
 
 out vec3 FragCoord;
@@ -26,7 +40,31 @@ void main() {
         mat4 viewNoTrans = mat4(mat3(ViewMatrix));  
         gl_Position = ProjectionMatrix * viewNoTrans * vec4(aSkyBoxVert, 1.0);
     } else {
-        Normal = aNormal;
+        // See PackVertex in VBO.h for the bit layout.
+        uvec2 record = aPacked;
+        if (uPullQuads == 1) {
+            record = texelFetch(uQuads, gl_VertexID / 6).xy;
+        }
+        uint d0 = record.x;
+        uint d1 = record.y;
+        ivec3 local = ivec3(int(d0 & 63u), int((d0 >> 6) & 63u), int((d0 >> 12) & 63u));
+        int face = int((d0 >> 18) & 7u);
+        if (uPullQuads == 1) {
+            int width = int(d1 & 63u);
+            int height = int((d1 >> 6) & 63u);
+            bool flip = (face == 1 || face == 2 || face == 5);
+            int corner = QuadCorners[(flip ? 6 : 0) + gl_VertexID % 6];
+            if ((corner & 1) != 0) local += WidthAxis[face / 2] * width;
+            if ((corner & 2) != 0) local += HeightAxis[face / 2] * height;
+        }
+        ivec3 wrapped = ivec3(int((d1 >> 12) & 63u), int((d1 >> 18) & 63u), int((d1 >> 24) & 63u));
+        int lod = int(d1 >> 30);
+        ivec3 cameraChunk = uCameraChunk >> lod;
+        ivec3 delta = (wrapped - cameraChunk) & 63;
+        delta -= ivec3(greaterThanEqual(delta, ivec3(32))) * 64;
+        vec3 aPos = vec3(((cameraChunk + delta) * CHUNK_SIZE + local) << lod);
+
+        Normal = FaceNormals[face];
         gl_Position = ProjectionMatrix * ViewMatrix * vec4(aPos, 1.0);
         FragCoord = vec3(model*vec4(aPos , 1.0));
     }